@@ -20,6 +20,7 @@
 #include "BaseFileSystemWidget.h"
 #include "BaseFileInfo.h"
 #include "BaseFileInfoItemDelegate.h"
+#include "BaseFileInfoModel.h"
 #include "ColumnSelectionMenu.h"
 #include "ColumnSortingMenu.h"
 #include "ContextMenu.h"
@@ -149,6 +150,7 @@ BaseFileSystemWidget::BaseFileSystemWidget( QWidget *parent ):
 
     list_->setMouseTracking( true );
     list_->setDragEnabled( true );
+    model_.setAsynchronousIcons( true );
     list_->setModel( &model_ );
     list_->setSelectionMode( QAbstractItemView::ContiguousSelection );
     list_->setOptionName( QStringLiteral("FILE_SYSTEM_LIST") );
@@ -180,7 +182,8 @@ BaseFileSystemWidget::BaseFileSystemWidget( QWidget *parent ):
     connect( list_, &TreeView::hovered, this, &BaseFileSystemWidget::_showToolTip );
 
     // connect filesystem watcher
-    connect( &fileSystemWatcher_, &QFileSystemWatcher::directoryChanged, this, QOverload<const QString&>::of( &BaseFileSystemWidget::_update ) );
+    fileSystemWatcher_.setDelay( 100 );
+    connect( &fileSystemWatcher_, &FileSystemWatcher::changesAvailable, this, &BaseFileSystemWidget::_processChanges );
 
     // connect thread
     connect( thread_.get(), &FileThread::filesAvailable, this, &BaseFileSystemWidget::_processFiles );
@@ -240,6 +243,13 @@ void BaseFileSystemWidget::setPath( const File &path, bool forced )
 
 }
 
+//______________________________________________________
+void BaseFileSystemWidget::changeEvent( QEvent* event )
+{
+    if( event->type() == QEvent::LocaleChange ) model_.invalidateDisplayStrings();
+    QWidget::changeEvent( event );
+}
+
 //______________________________________________________
 void BaseFileSystemWidget::_processFiles( const File::List& files )
 {
@@ -267,31 +277,84 @@ void BaseFileSystemWidget::_processFiles( const File::List& files )
     {
         // skip hidden files
         if( file.isHidden() && !hiddenFilesAction_->isChecked() ) continue;
+        records.append( _record( file ) );
+    }
 
-        // create file record
-        FileRecord record( file, file.lastModified() );
+    // update model
+    model_.update( records );
 
-        // assign size
-        record.addProperty( sizePropertyId_, QString::number(file.fileSize()) );
+    // update list
+    list_->updateMask();
+    list_->resizeColumnToContents( FileSystemModel::FileName );
 
-        // assign type
-        record.setFlag( file.isDirectory() ? BaseFileInfo::Folder : BaseFileInfo::Document );
-        if( file.isLink() ) record.setFlag( BaseFileInfo::Link );
-        if( file.isHidden() ) record.setFlag( BaseFileInfo::Hidden );
+    unsetCursor();
 
-        // add to model
-        records.append( record );
+}
+
+//______________________________________________________
+void BaseFileSystemWidget::_processChanges( const FileSystemWatcher::ChangeSet& changes )
+{
+
+    if( !isVisible() ) return;
+
+    // changes are unknown, or a listing is in progress. List again
+    const QString directory( pathEditor_->path() );
+    if( changes.rescan.contains( directory ) || ( changes.events.contains( directory ) && thread_->isRunning() ) )
+    {
+        _update();
+        return;
+    }
+
+    const auto events( changes.events.value( directory ) );
+    if( events.isEmpty() ) return;
+
+    Debug::Throw() << "BaseFileSystemWidget::_processChanges - " << directory << " changes: " << events.size() << Qt::endl;
+
+    // only changed entries are checked
+    FileRecord::List records;
+    File::List removed;
+    for( const auto& event:events )
+    {
+
+        const File file( File( event.name ).addPath( File( directory ), true ) );
+        if( event.type == FileSystemWatcher::Event::Type::Removed || !file.exists() )
+        {
+            removed.append( file );
+            continue;
+        }
+
+        // hidden files
+        if( file.isHidden() && !hiddenFilesAction_->isChecked() ) continue;
+        records.append( _record( file ) );
 
     }
 
     // update model
-    model_.update( records );
+    model_.applyChanges( records, removed );
 
     // update list
     list_->updateMask();
-    list_->resizeColumnToContents( FileSystemModel::FileName );
+    if( !records.isEmpty() ) list_->resizeColumnToContents( FileSystemModel::FileName );
 
-    unsetCursor();
+}
+
+//______________________________________________________
+FileRecord BaseFileSystemWidget::_record( const File& file ) const
+{
+
+    // create file record
+    FileRecord record( file, file.lastModified() );
+
+    // assign size. The string property is kept for users of FileRecordProperties::Size
+    record.setSize( file.fileSize() );
+    record.addProperty( sizePropertyId_, QString::number(file.fileSize()) );
+
+    // assign type
+    record.setFlag( file.isDirectory() ? BaseFileInfo::Folder : BaseFileInfo::Document );
+    if( file.isLink() ) record.setFlag( BaseFileInfo::Link );
+    if( file.isHidden() ) record.setFlag( BaseFileInfo::Hidden );
+
+    return record;
 
 }
 
@@ -355,10 +418,6 @@ void BaseFileSystemWidget::_updateFileSystemWatcher()
     fileSystemWatcher_.addPath( path );
 }
 
-//______________________________________________________
-void BaseFileSystemWidget::_update( const QString& value )
-{ if( isVisible() && value == pathEditor_->path() ) _update(); }
-
 //______________________________________________________
 void BaseFileSystemWidget::_update()
 {
@@ -403,10 +462,15 @@ void BaseFileSystemWidget::_showToolTip( const QModelIndex& index )
     else {
 
         // update tooltip content
-        const auto& record( model_.get( index ) );
+        auto record( model_.get( index ) );
         QIcon icon;
         const auto iconVariant( model_.data( index, Qt::DecorationRole ) );
         if( iconVariant.canConvert( QVariant::Icon ) ) icon = iconVariant.value<QIcon>();
+
+        // do not compose overlays twice
+        if( model_.data( index, Base::OverlaysAppliedRole ).toBool() )
+        { record.setFlags( record.flags() & ~(BaseFileInfo::Link|BaseFileInfo::Hidden) ); }
+
         toolTipWidget_->setRecord( record, icon );
 
         // move tooltip
@@ -22,11 +22,11 @@
 
 #include "File.h"
 #include "FileSystemModel.h"
+#include "FileSystemWatcher.h"
 #include "FileThread.h"
 #include "ThreadDeleter.h"
 #include "base_filesystem_export.h"
 
-#include <QFileSystemWatcher>
 #include <QIcon>
 #include <QMenu>
 #include <QWidget>
@@ -131,11 +131,20 @@ class BASE_FILESYSTEM_EXPORT BaseFileSystemWidget: public QWidget, private Base:
     //! update actions
     virtual void _updateActions();
 
+    //! change event
+    void changeEvent( QEvent* ) override;
+
     private:
 
     //! custom event, used to retrieve file validity check event
     void _processFiles( const File::List& );
 
+    //! apply changes reported by the file system watcher
+    void _processChanges( const FileSystemWatcher::ChangeSet& );
+
+    //! create record for a given file
+    FileRecord _record( const File& ) const;
+
     //! item activated
     void _itemActivated( const QModelIndex& );
 
@@ -154,9 +163,6 @@ class BASE_FILESYSTEM_EXPORT BaseFileSystemWidget: public QWidget, private Base:
     //! show tooltip
     void _showToolTip( const QModelIndex& );
 
-    //! update directory
-    void _update( const QString& );
-
     //! update directory
     void _update();
 
@@ -252,7 +258,7 @@ class BASE_FILESYSTEM_EXPORT BaseFileSystemWidget: public QWidget, private Base:
     File workingPath_;
 
     //! file system watcher
-    QFileSystemWatcher fileSystemWatcher_;
+    FileSystemWatcher fileSystemWatcher_;
 
     //! thread to list files
     std::unique_ptr<FileThread, Base::ThreadDeleter> thread_;
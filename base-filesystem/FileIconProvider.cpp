@@ -19,6 +19,7 @@
 
 #include "FileIconProvider.h"
 #include "BaseFileInfo.h"
+#include "DefaultFolders.h"
 #include "FileSystemIconNames.h"
 #include "FileSystemModel.h"
 #include "IconEngine.h"
@@ -27,6 +28,10 @@
 //__________________________________________________________________
 const QIcon& FileIconProvider::icon( const FileRecord& fileRecord )
 {
+
+    // decode in worker threads, composing overlays
+    if( isAsynchronous() ) return _icon( key( fileRecord ), _iconNames( fileRecord ) );
+
     // get relevant file info type
     int type( fileRecord.flags() );
     if( type & BaseFileInfo::Folder )
@@ -70,3 +75,50 @@ const QIcon& FileIconProvider::icon( const FileRecord& fileRecord )
     return _icons().insert( key, out ).value();
 
 }
+
+//__________________________________________________________________
+BaseFileIconProvider::Key FileIconProvider::key( const FileRecord& fileRecord ) const
+{
+
+    const int type( fileRecord.flags() );
+    if( type & BaseFileInfo::Navigator ) return Key( QString(), BaseFileInfo::Navigator );
+
+    // default folders have dedicated icons
+    if( ( type & BaseFileInfo::Folder ) && DefaultFolders::get().type( fileRecord.file() ) != DefaultFolders::Type::Unknown )
+    { return Key( fileRecord.file(), type & BaseFileInfo::Any ); }
+
+    return Key( fileRecord.file().extension(), type & BaseFileInfo::Any );
+
+}
+
+//__________________________________________________________________
+QStringList FileIconProvider::_iconNames( const FileRecord& fileRecord ) const
+{
+
+    const int type( fileRecord.flags() );
+    if( type & BaseFileInfo::Navigator ) return { IconNames::Parent };
+    else if( type & BaseFileInfo::Folder )
+    {
+
+        QStringList out;
+        const auto folderType( DefaultFolders::get().type( fileRecord.file() ) );
+        if( folderType != DefaultFolders::Type::Unknown )
+        {
+            const auto iconName( DefaultFolders::get().iconName( folderType ) );
+            if( !iconName.isEmpty() ) out.append( iconName );
+        }
+
+        out.append( IconNames::Folder );
+        return out;
+
+    } else if( type & BaseFileInfo::Document ) {
+
+        QStringList out;
+        const auto iconName( mimeTypeIconProvider_.iconName( fileRecord.file().extension() ) );
+        if( !iconName.isEmpty() ) out.append( iconName );
+        out.append( IconNames::Document );
+        return out;
+
+    } else return {};
+
+}
@@ -46,8 +46,14 @@ class BASE_FILESYSTEM_EXPORT FileIconProvider : public BaseFileIconProvider
     using BaseFileIconProvider::icon;
     const QIcon& icon( const FileRecord& );
 
+    //* cache key matching given record, in asynchronous mode
+    Key key( const FileRecord& ) const;
+
     private:
 
+    //* icon names matching given record, in asynchronous mode
+    QStringList _iconNames( const FileRecord& ) const;
+
     //* mime type icon provider
     MimeTypeIconProvider mimeTypeIconProvider_;
 
@@ -26,6 +26,7 @@
 #include "IconEngine.h"
 #include "Pixmap.h"
 #include "QtUtil.h"
+#include "Singleton.h"
 #include "XmlOptions.h"
 
 
@@ -34,15 +35,34 @@
 #include <QPalette>
 #include <QUrl>
 
+#include <algorithm>
+#include <functional>
+
 //__________________________________________________________________
 FileSystemModel::FileSystemModel( QObject* parent ):
     ListModel( parent ),
     Counter( QStringLiteral("FileSystemModel") ),
-    columnTitles_( { tr( "File" ), tr( "Size" ), tr( "Last Accessed" ) } ),
-    sizePropertyId_( FileRecord::PropertyId::get( FileRecordProperties::Size ) )
+    columnTitles_( { tr( "File" ), tr( "Size" ), tr( "Last Accessed" ) } )
 {
     Debug::Throw(QStringLiteral("FileSystemModel::FileSystemModel.\n") );
     iconProvider_ = new FileIconProvider( this );
+    connect( iconProvider_, &BaseFileIconProvider::iconAvailable, this, &FileSystemModel::_iconAvailable );
+    connect( &Base::Singleton::get(), &Base::Singleton::configurationChanged, this, &FileSystemModel::invalidateDisplayStrings );
+
+    // rows must be indexed again whenever the layout changes
+    const auto setRowsDirty = [this]() { rowsDirty_ = true; };
+    connect( this, &QAbstractItemModel::layoutChanged, this, setRowsDirty );
+    connect( this, &QAbstractItemModel::modelReset, this, setRowsDirty );
+    connect( this, &QAbstractItemModel::rowsInserted, this, setRowsDirty );
+    connect( this, &QAbstractItemModel::rowsRemoved, this, setRowsDirty );
+    connect( this, &QAbstractItemModel::rowsMoved, this, setRowsDirty );
+}
+
+//__________________________________________________________________
+void FileSystemModel::setAsynchronousIcons( bool value )
+{
+    pendingIcons_.clear();
+    iconProvider_->setAsynchronous( value );
 }
 
 //__________________________________________________________________
@@ -89,14 +109,14 @@ QVariant FileSystemModel::data( const QModelIndex& index, int role ) const
                 case Size:
                 {
                     const FileRecord& record( get(index) );
-                    if( record.hasFlag( BaseFileInfo::Document ) ) return QString( record.property( sizePropertyId_ ) );
+                    if( record.hasFlag( BaseFileInfo::Document ) ) return record.sizeString();
                     else return {};
                 }
 
                 case Time:
                 {
                     const FileRecord& record( get(index) );
-                    if( record.hasFlag( BaseFileInfo::Document ) ) return QString( TimeStamp( record.time() ).toString() );
+                    if( record.hasFlag( BaseFileInfo::Document ) ) return record.timeString();
                     else return {};
                 }
 
@@ -113,10 +133,19 @@ QVariant FileSystemModel::data( const QModelIndex& index, int role ) const
         {
 
             const FileRecord& record( get(index) );
-            return iconProvider_->icon( record );
+            const auto& icon( iconProvider_->icon( record ) );
+
+            // store file, to emit dataChanged for its current row once icon is available
+            if( iconProvider_->isPlaceholder( icon ) )
+            { pendingIcons_[iconProvider_->key( record )].insert( record.file() ); }
+
+            return icon;
 
         } else break;
 
+        case Base::OverlaysAppliedRole:
+        return showIcons_ && index.column() == FileName && iconProvider_->isAsynchronous();
+
         case Qt::ForegroundRole:
         {
             const FileRecord& record( get(index) );
@@ -210,6 +239,146 @@ QMimeData* FileSystemModel::mimeData(const QModelIndexList &indexes) const
 
 }
 
+//____________________________________________________________
+void FileSystemModel::_iconAvailable( const BaseFileIconProvider::Key& key )
+{
+    const auto files( pendingIcons_.take( key ) );
+    for( const auto& file:files )
+    {
+        const int row( _row( file ) );
+        if( row < 0 ) continue;
+        const auto index( this->index( row, FileName ) );
+        emit dataChanged( index, index, { Qt::DecorationRole } );
+    }
+}
+
+//____________________________________________________________
+int FileSystemModel::_row( const QString& file ) const
+{
+    if( rowsDirty_ )
+    {
+        rows_.clear();
+        const auto& records( get() );
+        for( int row = 0; row < records.size(); ++row )
+        { rows_.insert( records[row].file(), row ); }
+        rowsDirty_ = false;
+    }
+
+    return rows_.value( file, -1 );
+}
+
+//____________________________________________________________
+void FileSystemModel::invalidateDisplayStrings()
+{
+    FileRecord::invalidateDisplayStrings();
+    if( rowCount() > 0 ) emit dataChanged( index( 0, Size ), index( rowCount()-1, Time ), { Qt::DisplayRole } );
+}
+
+//____________________________________________________________
+void FileSystemModel::applyChanges( const List& records, const File::List& removed )
+{
+
+    Debug::Throw( QStringLiteral("FileSystemModel::applyChanges.\n") );
+    if( records.isEmpty() && removed.isEmpty() ) return;
+
+    // index changes by file name
+    QHash<QString, FileRecord> changed;
+    for( const auto& record:records )
+    { changed.insert( record.file(), record ); }
+
+    QSet<QString> removedFiles;
+    for( const auto& file:removed )
+    { removedFiles.insert( file ); }
+
+    // large batches are merged and sorted at once
+    const int changeCount( changed.size() + removedFiles.size() );
+    if( changeCount > 32 && changeCount*8 > rowCount() )
+    {
+        _applyChangesInLayout( changed, removedFiles );
+        return;
+    }
+
+    const SortFTor sortFTor( sortColumn(), sortOrder(), columnTitles_ );
+    auto& values( _get() );
+
+    // rows to be removed, and records to be inserted at their sorted position
+    QSet<int> removedRows;
+    for( const auto& file:removedFiles )
+    {
+        const int row( _row( file ) );
+        if( row >= 0 ) removedRows.insert( row );
+    }
+
+    List insertedRecords;
+    for( const auto& record:changed )
+    {
+        const int row( _row( record.file() ) );
+        if( row < 0 || removedRows.contains( row ) ) insertedRecords.append( record );
+        else if( !( sortFTor( record, values[row] ) || sortFTor( values[row], record ) ) ) {
+
+            // sort position is unchanged, update in place
+            values[row] = record;
+            emit dataChanged( index( row, 0 ), index( row, nColumns-1 ) );
+
+        } else {
+
+            // move to new sorted position
+            removedRows.insert( row );
+            insertedRecords.append( record );
+
+        }
+    }
+
+    // remove, starting from the last row so that remaining rows are unchanged
+    auto sortedRows( removedRows.values() );
+    std::sort( sortedRows.begin(), sortedRows.end(), std::greater<int>() );
+    for( const auto& row:sortedRows )
+    {
+        beginRemoveRows( QModelIndex(), row, row );
+        _removeRow( row );
+        endRemoveRows();
+    }
+
+    // insert at sorted position
+    for( const auto& record:insertedRecords )
+    {
+        const int row( std::upper_bound( values.begin(), values.end(), record, sortFTor ) - values.begin() );
+        beginInsertRows( QModelIndex(), row, row );
+        values.insert( row, record );
+        endInsertRows();
+    }
+
+}
+
+//____________________________________________________________
+void FileSystemModel::_applyChangesInLayout( QHash<QString, FileRecord> changed, const QSet<QString>& removedFiles )
+{
+
+    Debug::Throw( QStringLiteral("FileSystemModel::_applyChangesInLayout.\n") );
+
+    emit layoutAboutToBeChanged();
+
+    // remove and update existing records in a single pass
+    _removeIf( [&removedFiles]( const FileRecord& record ) { return removedFiles.contains( record.file() ); } );
+    for( auto& value:_get() )
+    {
+        auto iter( changed.find( value.file() ) );
+        if( iter != changed.end() )
+        {
+            value = iter.value();
+            changed.erase( iter );
+        }
+    }
+
+    // remaining records are new
+    for( auto&& iter = changed.begin(); iter != changed.end(); ++iter )
+    { _get().append( iter.value() ); }
+
+    _sort();
+    emit layoutChanged();
+
+}
+
 //____________________________________________________________
 void FileSystemModel::_sort( int column, Qt::SortOrder order )
 { std::sort( _get().begin(), _get().end(), SortFTor( column, order, columnTitles_ ) ); }
@@ -217,7 +386,6 @@ void FileSystemModel::_sort( int column, Qt::SortOrder order )
 //________________________________________________________
 FileSystemModel::SortFTor::SortFTor( int type, Qt::SortOrder order, const QStringList& columnTitles ):
     ItemModel::SortFTor( type, order ),
-    sizePropertyId_( FileRecord::PropertyId::get( FileRecordProperties::Size ) ),
     columnTitles_( columnTitles )
 {}
 
@@ -246,12 +414,7 @@ bool FileSystemModel::SortFTor::operator () ( FileRecord first, FileRecord secon
         }
 
         case Time: return (first.time() != second.time() ) ? first.time() < second.time() : first.file().localName() < second.file().localName();
-        case Size:
-        {
-            long first_size( first.property( sizePropertyId_ ).toInt() );
-            long second_size( second.property( sizePropertyId_ ).toInt() );
-            return (first_size != second_size ) ? first_size < second_size : first.file().localName() < second.file().localName();
-        }
+        case Size: return (first.size() != second.size() ) ? first.size() < second.size() : first.file().localName() < second.file().localName();
 
         default: return true;
 
@@ -20,6 +20,7 @@
 *
 *******************************************************************************/
 
+#include "BaseFileIconProvider.h"
 #include "Counter.h"
 #include "Debug.h"
 #include "FileRecord.h"
@@ -28,6 +29,7 @@
 
 #include <QHash>
 #include <QMimeData>
+#include <QSet>
 #include <QStringList>
 
 class FileIconProvider;
@@ -84,6 +86,22 @@ class BASE_FILESYSTEM_EXPORT FileSystemModel: public ListModel<FileRecord>, priv
     void setUseLocalNames( bool value )
     { useLocalNames_ = value; }
 
+    //* decode icons asynchronously
+    void setAsynchronousIcons( bool );
+
+    //* invalidate cached size and time strings, for instance on locale change
+    void invalidateDisplayStrings();
+
+    //* apply incremental changes
+    /**
+    records are replaced when already present and added otherwise;
+    records matching the removed files are removed. The passed lists need only contain the changes.
+    Small batches are applied row by row: records whose sort position is unchanged are updated in place,
+    others are removed and inserted back at their sorted position. Large batches are merged in a single pass
+    and sorted at once.
+    */
+    void applyChanges( const List&, const File::List& );
+
     //@}
 
     protected:
@@ -93,9 +111,29 @@ class BASE_FILESYSTEM_EXPORT FileSystemModel: public ListModel<FileRecord>, priv
 
     private:
 
+    //* emit data changed for rows waiting for a given icon
+    void _iconAvailable( const BaseFileIconProvider::Key& );
+
+    //* merge changes in a single pass, and sort, within a layout change
+    void _applyChangesInLayout( QHash<QString, FileRecord>, const QSet<QString>& );
+
+    //* current row of a given file, or -1 if not found
+    int _row( const QString& ) const;
+
     //* icon provider
     FileIconProvider* iconProvider_ = nullptr;
 
+    //* files showing a placeholder, for a given icon key
+    /** files are stored rather than rows, since rows change when sorting or updating the model */
+    using FileSet = QSet<QString>;
+    mutable QHash<BaseFileIconProvider::Key, FileSet> pendingIcons_;
+
+    //* rows, indexed by file
+    mutable QHash<QString, int> rows_;
+
+    //* true if rows must be indexed again, after layout changes
+    mutable bool rowsDirty_ = true;
+
     //* used to sort Counters
     class BASE_FILESYSTEM_EXPORT SortFTor: public ItemModel::SortFTor
     {
@@ -110,9 +148,6 @@ class BASE_FILESYSTEM_EXPORT FileSystemModel: public ListModel<FileRecord>, priv
 
         private:
 
-        //* size property id
-        FileRecord::PropertyId::Id sizePropertyId_;
-
         //* column titles
         QStringList columnTitles_;
 
@@ -127,9 +162,6 @@ class BASE_FILESYSTEM_EXPORT FileSystemModel: public ListModel<FileRecord>, priv
     //* column titles
     QStringList columnTitles_;
 
-    //* size property id
-    FileRecord::PropertyId::Id sizePropertyId_ = 0;
-
 };
 
 #endif
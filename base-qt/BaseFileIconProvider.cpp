@@ -19,10 +19,17 @@
 
 #include "BaseFileIconProvider.h"
 #include "BaseIconNames.h"
+#include "Debug.h"
 #include "DefaultFolders.h"
 #include "IconEngine.h"
+#include "IconSize.h"
+#include "PixelKernels.h"
 #include "Pixmap.h"
 #include "Util.h"
+#include "XmlOptions.h"
+
+#include <QHash>
+#include <QPair>
 
 //__________________________________________________________________________
 BaseFileIconProvider::BaseFileIconProvider( QObject* parent ):
@@ -50,7 +57,7 @@ const QIcon& BaseFileIconProvider::icon( const BaseFileInfo& fileInfo, int type
     if( iconName.isEmpty() ) return invalid_;
 
     // get corresponding icon from icon engine
-    auto&& base( IconEngine::get( iconName ) );
+    const QIcon base( IconEngine::get( iconName ) );
     if( base.isNull() ) return invalid_;
 
     // insert in map and return
@@ -59,6 +66,62 @@ const QIcon& BaseFileIconProvider::icon( const BaseFileInfo& fileInfo, int type
 }
 
 
+//__________________________________________________________________________
+void BaseFileIconProvider::setAsynchronous( bool value )
+{
+    Debug::Throw() << "BaseFileIconProvider::setAsynchronous - value: " << value << Qt::endl;
+    if( value == isAsynchronous() ) return;
+
+    // cached icons do not have overlays composed in synchronous mode
+    icons_.clear();
+    pending_.clear();
+
+    if( value )
+    {
+
+        // transparent placeholder
+        QPixmap pixmap( IconSize::get( IconSize::Maximum ) );
+        pixmap.fill( Qt::transparent );
+        placeholder_ = QIcon( pixmap );
+
+        decoder_ = new IconDecoder( this );
+        decoder_->setPixmapPath( XmlOptions::get().specialOptions<File>( QStringLiteral("PIXMAP_PATH") ) );
+        connect( decoder_, &IconDecoder::imagesAvailable, this, &BaseFileIconProvider::_imagesAvailable );
+
+    } else {
+
+        delete decoder_;
+        decoder_ = nullptr;
+
+    }
+
+}
+
+//__________________________________________________________________________
+const QIcon& BaseFileIconProvider::_icon( const Key& key, const QStringList& iconNames )
+{
+
+    // check cache
+    auto&& iter( icons_.find( key ) );
+    if( iter != icons_.end() ) return iter.value();
+
+    // send request to decoder, unless already in flight
+    const QString decoderKey( QStringLiteral( "%1:%2" ).arg( key.type() ).arg( key.file() ) );
+    if( !pending_.contains( decoderKey ) )
+    {
+        pending_.insert( decoderKey, qMakePair( key, iconNames ) );
+
+        IconDecoder::Request request;
+        request.key = decoderKey;
+        request.iconNames = iconNames;
+        request.type = key.type();
+        decoder_->request( request );
+    }
+
+    return placeholder_;
+
+}
+
 //____________________________________________________
 Pixmap BaseFileIconProvider::linked( const Pixmap& source )
 {
@@ -67,23 +130,22 @@ Pixmap BaseFileIconProvider::linked( const Pixmap& source )
     auto linkOverlay( IconEngine::get( IconNames::SymbolicLink ) );
     if( linkOverlay.isNull() ) return source;
 
-    // get source size
-    auto size( source.size()/source.devicePixelRatio() );
-
     // decide overlay size
-    QSize overlaySize;
-    if( size.width() <= 16 ) overlaySize = QSize( 10, 10 );
-    else if( size.width() <= 22 ) overlaySize = QSize( 12, 12 );
-    else if( size.width() <= 32 ) overlaySize = QSize( 16, 16 );
-    else if( size.width() <= 48 ) overlaySize = QSize( 16, 16 );
-    else if( size.width() <= 64 ) overlaySize = QSize( 22, 22 );
-    else if( size.width() <= 128 ) overlaySize = QSize( 48, 48 );
-    else overlaySize = QSize( 64, 64 );
-
-    Pixmap overlayPixmap( linkOverlay.pixmap( overlaySize ) );
-    return source.merged(
-        overlayPixmap.scaled( overlaySize*overlayPixmap.devicePixelRatio(), Qt::KeepAspectRatio, Qt::SmoothTransformation ),
-        Pixmap::Corner::BottomRight );
+    const QSize overlaySize( linkOverlaySize( source.size()/source.devicePixelRatio() ) );
+
+    // scaled overlays are kept, so that merged pixmaps are found in the pixmap effect cache
+    using OverlayKey = QPair<qint64, int>;
+    static QHash<OverlayKey, Pixmap> overlays;
+    const OverlayKey key( linkOverlay.cacheKey(), overlaySize.width() );
+    auto iter( overlays.find( key ) );
+    if( iter == overlays.end() )
+    {
+        if( overlays.size() > 32 ) overlays.clear();
+        Pixmap overlayPixmap( linkOverlay.pixmap( overlaySize ) );
+        iter = overlays.insert( key, Pixmap( overlayPixmap.scaled( overlaySize*overlayPixmap.devicePixelRatio(), Qt::KeepAspectRatio, Qt::SmoothTransformation ) ) );
+    }
+
+    return source.merged( iter.value(), Pixmap::Corner::BottomRight );
 
 }
 
@@ -94,3 +156,96 @@ Pixmap BaseFileIconProvider::hidden( const Pixmap& source )
 //____________________________________________________
 Pixmap BaseFileIconProvider::clipped( const Pixmap& source )
 { return source.desaturated().transparent( 0.6 ); }
+
+//____________________________________________________
+QSize BaseFileIconProvider::linkOverlaySize( const QSize& size )
+{
+    if( size.width() <= 16 ) return QSize( 10, 10 );
+    else if( size.width() <= 22 ) return QSize( 12, 12 );
+    else if( size.width() <= 32 ) return QSize( 16, 16 );
+    else if( size.width() <= 48 ) return QSize( 16, 16 );
+    else if( size.width() <= 64 ) return QSize( 22, 22 );
+    else if( size.width() <= 128 ) return QSize( 48, 48 );
+    else return QSize( 64, 64 );
+}
+
+//____________________________________________________
+QImage BaseFileIconProvider::linked( const QImage& source, const QImage& overlay )
+{
+    if( source.isNull() || overlay.isNull() ) return source;
+
+    QImage out( source );
+    Base::PixelKernels::sourceOver( out, overlay, QPoint( out.width()-overlay.width(), out.height()-overlay.height() ) );
+    return out;
+}
+
+//____________________________________________________
+QImage BaseFileIconProvider::hidden( const QImage& source )
+{
+    if( source.isNull() ) return source;
+
+    QImage out( source );
+    Base::PixelKernels::scaleAlpha( out, qRound( 255*0.6 ) );
+    return out;
+}
+
+//____________________________________________________
+QImage BaseFileIconProvider::clipped( const QImage& source )
+{
+    if( source.isNull() ) return source;
+
+    QImage out( source );
+    Base::PixelKernels::desaturate( out );
+    return hidden( out );
+}
+
+//____________________________________________________
+void BaseFileIconProvider::_imagesAvailable( const QString& decoderKey, const IconDecoder::ImageList& images )
+{
+
+    // find matching request
+    auto&& iter( pending_.find( decoderKey ) );
+    if( iter == pending_.end() ) return;
+
+    const auto key( iter.value().first );
+    const auto iconNames( iter.value().second );
+    pending_.erase( iter );
+
+    // create icon
+    QIcon icon;
+    if( images.isEmpty() ) icon = _fallbackIcon( iconNames, key.type() );
+    else {
+        for( const auto& image:images )
+        { icon.addPixmap( QPixmap::fromImage( image ) ); }
+    }
+
+    // store and notify
+    icons_.insert( key, icon );
+    emit iconAvailable( key );
+
+}
+
+//____________________________________________________
+QIcon BaseFileIconProvider::_fallbackIcon( const QStringList& iconNames, int type ) const
+{
+
+    for( const auto& iconName:iconNames )
+    {
+
+        // icon engine also looks up icon theme
+        const QIcon base( IconEngine::get( iconName ) );
+        if( base.isNull() ) continue;
+        if( !( type & (BaseFileInfo::Link|BaseFileInfo::Hidden|BaseFileInfo::Clipped) ) ) return base;
+
+        // compose overlays
+        Pixmap pixmap( base.pixmap( IconSize::get( IconSize::Maximum ) ) );
+        if( type & BaseFileInfo::Link ) pixmap = linked( pixmap );
+        if( type & BaseFileInfo::Hidden ) pixmap = hidden( pixmap );
+        if( type & BaseFileInfo::Clipped ) pixmap = clipped( pixmap );
+        return QIcon( pixmap );
+
+    }
+
+    return QIcon();
+
+}
@@ -23,12 +23,15 @@
 #include "BaseFileInfo.h"
 #include "Counter.h"
 #include "File.h"
+#include "IconDecoder.h"
 #include "Pixmap.h"
 #include "base_qt_export.h"
 
 #include <QHash>
 #include <QIcon>
+#include <QImage>
 #include <QObject>
+#include <QPair>
 
 //* returns icon for a given FileInfo
 class BASE_QT_EXPORT BaseFileIconProvider: public QObject, private Base::Counter<BaseFileIconProvider>
@@ -52,6 +55,26 @@ class BASE_QT_EXPORT BaseFileIconProvider: public QObject, private Base::Counter
     virtual void clear()
     { icons_.clear(); }
 
+    //*@name asynchronous decoding
+    //@{
+
+    /**
+    \brief asynchronous mode
+    icons are decoded and composed in worker threads.
+    A placeholder is returned until the icon is available
+    */
+    void setAsynchronous( bool );
+
+    //* asynchronous mode
+    bool isAsynchronous() const
+    { return decoder_; }
+
+    //* true if icon is the placeholder returned for in-flight requests
+    bool isPlaceholder( const QIcon& icon ) const
+    { return &icon == &placeholder_; }
+
+    //@}
+
     //* key, used for hash
     class BASE_QT_EXPORT Key
     {
@@ -97,10 +120,30 @@ class BASE_QT_EXPORT BaseFileIconProvider: public QObject, private Base::Counter
     //* add clipped effect
     static Pixmap clipped( const Pixmap& );
 
+    //* link overlay size for a given icon size
+    static QSize linkOverlaySize( const QSize& );
+
+    //* add link overlay. Thread safe
+    static QImage linked( const QImage&, const QImage& );
+
+    //* add hidden effect. Thread safe
+    static QImage hidden( const QImage& );
+
+    //* add clipped effect. Thread safe
+    static QImage clipped( const QImage& );
+
     //@}
 
+    Q_SIGNALS:
+
+    //* emitted when an asynchronously decoded icon is available
+    void iconAvailable( const BaseFileIconProvider::Key& );
+
     protected:
 
+    //* icon matching key, decoded asynchronously from the first matching icon name
+    const QIcon& _icon( const Key&, const QStringList& );
+
     //* icon cache
     using IconCache = QHash<Key, QIcon>;
     IconCache& _icons()
@@ -108,12 +151,28 @@ class BASE_QT_EXPORT BaseFileIconProvider: public QObject, private Base::Counter
 
     private:
 
+    //* images available from decoder
+    void _imagesAvailable( const QString&, const IconDecoder::ImageList& );
+
+    //* synchronous icon, used when decoder could not find any image
+    QIcon _fallbackIcon( const QStringList&, int ) const;
+
     //* icon map
     IconCache icons_;
 
     //* invalid icon
     QIcon invalid_;
 
+    //* decoder
+    IconDecoder* decoder_ = nullptr;
+
+    //* in-flight requests, and matching icon names
+    using PendingMap = QHash<QString, QPair<Key, QStringList>>;
+    PendingMap pending_;
+
+    //* placeholder icon
+    QIcon placeholder_;
+
 };
 
 //* equal-to operator
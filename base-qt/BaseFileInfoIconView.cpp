@@ -25,7 +25,12 @@
 //______________________________________________________________
 BaseFileInfoIconView::BaseFileInfoIconView( QWidget* parent ):
     IconView( parent )
-{ Debug::Throw( QStringLiteral("BaseFileInfoIconView::BaseFileInfoIconView.\n") ); }
+{
+    Debug::Throw( QStringLiteral("BaseFileInfoIconView::BaseFileInfoIconView.\n") );
+
+    // directories can be large. Only load items when shown
+    setVirtualized( true );
+}
 
 //______________________________________________________________
 void BaseFileInfoIconView::_updateItem( IconViewItem& item, const QModelIndex& index ) const
@@ -37,6 +42,7 @@ void BaseFileInfoIconView::_updateItem( IconViewItem& item, const QModelIndex& i
     // get pixmap
     auto pixmap( item.pixmap() );
     if( pixmap.isNull() ) return;
+    if( model()->data( index, Base::OverlaysAppliedRole ).toBool() ) return;
 
     // check type role and customize pixmap
     auto&& fileTypeVariant( model()->data( index, Base::FileTypeRole ) );
@@ -38,6 +38,7 @@ void BaseFileInfoItemDelegate::initStyleOption( QStyleOptionViewItem* option, co
     // cast option and check icon
     QStyleOptionViewItem *optionV4 = qstyleoption_cast<QStyleOptionViewItem*>( option );
     if( !optionV4 || optionV4->icon.isNull() ) return;
+    if( index.data( Base::OverlaysAppliedRole ).toBool() ) return;
 
     // check type
     QVariant fileTypeVariant( index.data( Base::FileTypeRole ) );
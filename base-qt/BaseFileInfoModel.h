@@ -35,7 +35,10 @@ namespace Base
     //* custom role
     enum ItemDataRole
     {
-        FileTypeRole = Qt::UserRole+1
+        FileTypeRole = Qt::UserRole+1,
+
+        //* true if file type overlays are already composed into decoration
+        OverlaysAppliedRole
     };
 }
 
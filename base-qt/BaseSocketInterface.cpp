@@ -20,100 +20,244 @@
 #include "BaseSocketInterface.h"
 #include "Debug.h"
 
+#include <QMetaMethod>
+#include <QtEndian>
+
+#include <cstring>
+
 static const int debugLevel = 1;
 
+namespace
+{
+
+    /*
+    frame format, all integers being little endian:
+    protocol version (1 byte), buffer type (4 bytes), payload size (4 bytes), payload
+    */
+
+    //* protocol version
+    const quint8 protocolVersion = 1;
+
+    //* frame header size
+    const int headerSize = 9;
+
+    //* frames smaller than this are merged before being written
+    const int coalesceSize = 4096;
+
+}
+
+//_______________________________________________________
+BaseSocketInterface::BaseSocketInterface( QObject* parent, Transport transport ):
+  QObject( parent )
+{
+    Debug::Throw( QStringLiteral("BaseSocketInterface::BaseSocketInterface.\n") );
+    if( transport == Transport::Local ) device_ = localSocket_ = new QLocalSocket( this );
+    else device_ = tcpSocket_ = new QTcpSocket( this );
+    _setup();
+}
+
 //_______________________________________________________
 BaseSocketInterface::BaseSocketInterface( QObject* parent, QTcpSocket* socket ):
   QObject( parent ),
-  socket_( socket )
+  tcpSocket_( socket ),
+  device_( socket )
 {
     Debug::Throw( QStringLiteral("BaseSocketInterface::BaseSocketInterface.\n") );
-    if( !socket_ ) socket_ = new QTcpSocket( this );
-    connect( socket_, &QAbstractSocket::connected, this, &BaseSocketInterface::_sendPendingBuffers );
-    connect( socket_, &QIODevice::readyRead, this, &BaseSocketInterface::_read );
+    _setup();
 }
 
 //_______________________________________________________
-void BaseSocketInterface::sendBuffer( qint32 type, const QByteArray& buffer )
+BaseSocketInterface::BaseSocketInterface( QObject* parent, QLocalSocket* socket ):
+  QObject( parent ),
+  localSocket_( socket ),
+  device_( socket )
 {
-    if( socket().state() ==  QAbstractSocket::ConnectedState ) _sendBuffer( type, buffer );
-    else pendingBuffers_.append( BufferPair( type, buffer ) );
+    Debug::Throw( QStringLiteral("BaseSocketInterface::BaseSocketInterface.\n") );
+    _setup();
 }
 
 //_______________________________________________________
-void BaseSocketInterface::_sendPendingBuffers()
+QAbstractSocket::SocketState BaseSocketInterface::socketState() const
 {
+    // local socket states share values with QAbstractSocket
+    if( localSocket_ ) return QAbstractSocket::SocketState( localSocket_->state() );
+    else return tcpSocket_->state();
+}
 
-    for( const auto& bufferPair:pendingBuffers_ )
-    { _sendBuffer( bufferPair.first, bufferPair.second ); }
+//_______________________________________________________
+void BaseSocketInterface::connectToHost( const QHostAddress& host, quint16 port )
+{
+    if( tcpSocket_ ) tcpSocket_->connectToHost( host, port );
+    else Debug::Throw(0) << "BaseSocketInterface::connectToHost - invalid transport" << Qt::endl;
+}
 
-    pendingBuffers_.clear();
+//_______________________________________________________
+void BaseSocketInterface::connectToServer( const QString& name )
+{
+    if( localSocket_ ) localSocket_->connectToServer( name );
+    else Debug::Throw(0) << "BaseSocketInterface::connectToServer - invalid transport" << Qt::endl;
+}
 
+//_______________________________________________________
+QByteArray BaseSocketInterface::frame( qint32 type, const QByteArray& buffer )
+{
+    // header and payload are stored in a single contiguous buffer
+    QByteArray out( headerSize + buffer.size(), Qt::Uninitialized );
+    uchar* data = reinterpret_cast<uchar*>( out.data() );
+    data[0] = protocolVersion;
+    qToLittleEndian<qint32>( type, data+1 );
+    qToLittleEndian<quint32>( buffer.size(), data+5 );
+    if( !buffer.isEmpty() ) std::memcpy( data + headerSize, buffer.constData(), buffer.size() );
+    return out;
 }
 
 //_______________________________________________________
-void BaseSocketInterface::_sendBuffer( qint32 type, const QByteArray& buffer )
+void BaseSocketInterface::sendFrame( const QByteArray& frame )
 {
-    buffersize_t bufferSize( buffer.size() );
-    Debug::Throw(debugLevel) << "BaseSocketInterface::_sendBuffer - type: " << type << " size: " << bufferSize << Qt::endl;
-    socket_->write( reinterpret_cast<const char*>( &type ), sizeof( buffertype_t ) );
-    socket_->write( reinterpret_cast<const char*>( &bufferSize ), sizeof( buffersize_t ) );
-    socket_->write( buffer );
+    Debug::Throw(debugLevel) << "BaseSocketInterface::sendFrame - size: " << frame.size() << Qt::endl;
+    pendingFrames_.append( frame );
+
+    // frames sent within the same event loop iteration are written together
+    if( !flushScheduled_ )
+    {
+        flushScheduled_ = true;
+        QMetaObject::invokeMethod( this, &BaseSocketInterface::_sendPendingBuffers, Qt::QueuedConnection );
+    }
 }
 
 //_______________________________________________________
-void BaseSocketInterface::_read()
+void BaseSocketInterface::_sendPendingBuffers()
 {
 
-    if( !socket_->bytesAvailable() ) return;
+    flushScheduled_ = false;
+    if( pendingFrames_.isEmpty() || socketState() != QAbstractSocket::ConnectedState ) return;
 
-    Debug::Throw(debugLevel) << "BaseSocketInterface::_read - bytes: " << socket_->bytesAvailable() << Qt::endl;
-    forever
+    // single frame, possibly shared with other sockets, is written without copy
+    if( pendingFrames_.size() == 1 )
     {
+        device_->write( pendingFrames_.front() );
+        pendingFrames_.clear();
+        return;
+    }
 
-        // buffer type
-        if( bufferType_ < 0 )
-        {
-            if( socket_->bytesAvailable() >= int(sizeof( buffertype_t )) ) socket_->read( reinterpret_cast<char*>( &bufferType_ ), sizeof( buffertype_t ) );
-            else break;
+    // small frames are merged, large ones are written as is
+    QByteArray merged;
+    for( const auto& frame:pendingFrames_ )
+    {
+        if( frame.size() < coalesceSize ) merged.append( frame );
+        else {
 
-            Debug::Throw(debugLevel)
-                << "BaseSocketInterface::_read -"
-                << " bufferType: " << bufferType_
-                << " bytes: " << socket_->bytesAvailable()
-                << Qt::endl;
+            if( !merged.isEmpty() )
+            {
+                device_->write( merged );
+                merged.clear();
+            }
+
+            device_->write( frame );
 
         }
+    }
 
-        if( bufferSize_ == 0 )
+    if( !merged.isEmpty() ) device_->write( merged );
+    pendingFrames_.clear();
+
+}
+
+//_______________________________________________________
+void BaseSocketInterface::_read()
+{
+
+    // received buffers are views on buffer_, which must not change while they are being processed
+    if( reading_ ) return;
+    reading_ = true;
+
+    while( const qint64 bytesAvailable = device_->bytesAvailable() )
+    {
+
+        Debug::Throw(debugLevel) << "BaseSocketInterface::_read - bytes: " << bytesAvailable << Qt::endl;
+
+        // append to existing data, reusing allocated memory
+        const int offset( buffer_.size() );
+        buffer_.resize( offset + int( bytesAvailable ) );
+        const qint64 bytesRead( device_->read( buffer_.data() + offset, bytesAvailable ) );
+        buffer_.resize( offset + int( qMax<qint64>( bytesRead, 0 ) ) );
+        if( bytesRead <= 0 ) break;
+
+        // parse complete frames
+        int position = 0;
+        while( buffer_.size() - position >= headerSize )
         {
-            if( socket_->bytesAvailable() >= int(sizeof( buffersize_t )) ) socket_->read( reinterpret_cast<char*>( &bufferSize_ ), sizeof( buffersize_t ) );
-            else break;
-
-            Debug::Throw(debugLevel)
-                << "BaseSocketInterface::_read -"
-                << " bufferSize: " << bufferSize_
-                << " bytes: " << socket_->bytesAvailable()
-                << Qt::endl;
+
+            const uchar* data = reinterpret_cast<const uchar*>( buffer_.constData() + position );
+            if( data[0] != protocolVersion )
+            {
+                Debug::Throw(0) << "BaseSocketInterface::_read - invalid protocol version: " << int( data[0] ) << Qt::endl;
+                buffer_.clear();
+                reading_ = false;
+                _abort();
+                return;
+            }
+
+            const qint32 type( qFromLittleEndian<qint32>( data+1 ) );
+            const quint32 size( qFromLittleEndian<quint32>( data+5 ) );
+            if( quint64( buffer_.size() - position - headerSize ) < size ) break;
+
+            _processBuffer( type, QByteArray::fromRawData( buffer_.constData() + position + headerSize, int( size ) ) );
+            position += headerSize + int( size );
+
         }
 
-        if( bufferSize_ == 0 ) break;
-        if( quint64(socket_->bytesAvailable()) >= bufferSize_ )
+        // keep incomplete frame only
+        if( position > 0 ) buffer_.remove( 0, position );
+
+    }
+
+    reading_ = false;
+
+}
+
+//_______________________________________________________
+void BaseSocketInterface::_processBuffer( qint32 type, const QByteArray& buffer )
+{
+    // emitted buffers own their data, since they can be kept or queued by receivers
+    static const QMetaMethod signal( QMetaMethod::fromSignal( &BaseSocketInterface::bufferReceived ) );
+    if( isSignalConnected( signal ) ) emit bufferReceived( type, QByteArray( buffer.constData(), buffer.size() ) );
+}
+
+//_______________________________________________________
+void BaseSocketInterface::_abort()
+{
+    if( localSocket_ ) localSocket_->abort();
+    else tcpSocket_->abort();
+}
+
+//_______________________________________________________
+void BaseSocketInterface::_setup()
+{
+
+    connect( device_, &QIODevice::readyRead, this, &BaseSocketInterface::_read );
+    connect( this, &BaseSocketInterface::connected, this, &BaseSocketInterface::_sendPendingBuffers );
+
+    if( localSocket_ )
+    {
+
+        connect( localSocket_, &QLocalSocket::connected, this, &BaseSocketInterface::connected );
+        connect( localSocket_, &QLocalSocket::disconnected, this, &BaseSocketInterface::disconnected );
+        connect( localSocket_, &QLocalSocket::errorOccurred, this, [this]( QLocalSocket::LocalSocketError error )
         {
+            // local socket errors share values with QAbstractSocket. A missing server is reported as a refused connection
+            const auto socketError( error == QLocalSocket::ServerNotFoundError ? QAbstractSocket::ConnectionRefusedError : QAbstractSocket::SocketError( error ) );
+
+            // errors can be emitted from within connectToServer. They are delayed, as for tcp sockets
+            QMetaObject::invokeMethod( this, [this, socketError]() { emit errorOccurred( socketError ); }, Qt::QueuedConnection );
+        } );
 
-            const QByteArray array = socket_->read( bufferSize_ );
-            const buffertype_t bufferType = bufferType_;
-            bufferSize_ = 0;
-            bufferType_ = -1;
-            emit bufferReceived( bufferType, array );
+    } else {
 
-            Debug::Throw(debugLevel)
-                << "BaseSocketInterface::_read -"
-                << " array size: " << array.size()
-                << " bytes: " << socket_->bytesAvailable()
-                << Qt::endl;
+        connect( tcpSocket_, &QAbstractSocket::connected, this, &BaseSocketInterface::connected );
+        connect( tcpSocket_, &QAbstractSocket::disconnected, this, &BaseSocketInterface::disconnected );
+        connect( tcpSocket_, &QAbstractSocket::errorOccurred, this, &BaseSocketInterface::errorOccurred );
 
-        } else break;
     }
 
 }
@@ -23,8 +23,16 @@
 #include "Functors.h"
 #include "base_qt_export.h"
 
+#include <QAbstractSocket>
+#include <QHostAddress>
+#include <QLocalSocket>
 #include <QTcpSocket>
 
+//* framed buffer exchange over a tcp or local socket
+/**
+the local transport uses a QLocalSocket, which is a unix domain socket on unix platforms.
+Local socket states and errors are reported using the equivalent QAbstractSocket values
+*/
 class BASE_QT_EXPORT BaseSocketInterface: public QObject
 {
 
@@ -32,34 +40,88 @@ class BASE_QT_EXPORT BaseSocketInterface: public QObject
 
     public:
 
+    //* transport
+    enum class Transport
+    {
+        Tcp,
+        Local
+    };
+
     //* constructor
-    explicit BaseSocketInterface( QObject*, QTcpSocket* = nullptr );
+    explicit BaseSocketInterface( QObject*, Transport = Transport::Tcp );
+
+    //* constructor, from existing tcp socket
+    explicit BaseSocketInterface( QObject*, QTcpSocket* );
+
+    //* constructor, from existing local socket
+    explicit BaseSocketInterface( QObject*, QLocalSocket* );
 
     //*@name accessors
      //@{
 
-    //* associated socket
-    const QTcpSocket& socket() const
-    { return *socket_; }
+    //* transport
+    Transport transport() const
+    { return localSocket_ ? Transport::Local : Transport::Tcp; }
 
     //* socket state
-    QAbstractSocket::SocketState socketState() const
-    { return socket_->state(); }
+    QAbstractSocket::SocketState socketState() const;
+
+    //* error string
+    QString errorString() const
+    { return device_->errorString(); }
+
+    //* associated tcp socket. Only valid for tcp transport
+    const QTcpSocket& socket() const
+    {
+        Q_ASSERT( tcpSocket_ );
+        return *tcpSocket_;
+    }
+
+    //* associated local socket. Only valid for local transport
+    const QLocalSocket& localSocket() const
+    {
+        Q_ASSERT( localSocket_ );
+        return *localSocket_;
+    }
 
     //@}
 
     //*@name modifiers
     //@{
 
-    //* socket
+    //* associated tcp socket. Only valid for tcp transport
     QTcpSocket& socket()
-    { return *socket_; }
+    {
+        Q_ASSERT( tcpSocket_ );
+        return *tcpSocket_;
+    }
+
+    //* associated local socket. Only valid for local transport
+    QLocalSocket& localSocket()
+    {
+        Q_ASSERT( localSocket_ );
+        return *localSocket_;
+    }
+
+    //* connect to tcp server
+    void connectToHost( const QHostAddress&, quint16 );
+
+    //* connect to local server
+    void connectToServer( const QString& );
 
     //* write buffer of a given type
-    void sendBuffer( qint32, const QByteArray& );
+    void sendBuffer( qint32 type, const QByteArray& buffer )
+    { sendFrame( frame( type, buffer ) ); }
+
+    //* write frame, as returned by frame
+    /** frames are implicitly shared, so that the same frame can be sent to several sockets without copy */
+    void sendFrame( const QByteArray& );
 
     //@}
 
+    //* build frame from buffer of a given type
+    static QByteArray frame( qint32, const QByteArray& );
+
     //* used to retrieve all readers for a given state
     using SameStateFTor = Base::Functor::Unary<BaseSocketInterface, QAbstractSocket::SocketState, &BaseSocketInterface::socketState>;
 
@@ -68,9 +130,25 @@ class BASE_QT_EXPORT BaseSocketInterface: public QObject
     //* received buffer of given type
     void bufferReceived( qint32, QByteArray );
 
+    //* connected
+    void connected();
+
+    //* disconnected
+    void disconnected();
+
+    //* error
+    void errorOccurred( QAbstractSocket::SocketError );
+
     protected:
 
-    //* send pending buffers
+    //* process received buffer of given type
+    /**
+    the buffer refers to data owned by the interface, to avoid copies, and is only valid until the method returns.
+    The default implementation emits bufferReceived with a copy, when connected
+    */
+    virtual void _processBuffer( qint32, const QByteArray& );
+
+    //* write pending frames
     void _sendPendingBuffers();
 
     //* read message from socket
@@ -78,26 +156,32 @@ class BASE_QT_EXPORT BaseSocketInterface: public QObject
 
     private:
 
-    //* send buffer
-    void _sendBuffer( qint32, const QByteArray& );
+    //* connect socket signals
+    void _setup();
+
+    //* abort connection
+    void _abort();
 
-    //* socket
-    QTcpSocket* socket_ = nullptr;
+    //* tcp socket
+    QTcpSocket* tcpSocket_ = nullptr;
 
-    //* running type
-    using buffertype_t = qint32;
-    buffertype_t bufferType_ = -1;
+    //* local socket
+    QLocalSocket* localSocket_ = nullptr;
 
-    //* running lenght
-    using buffersize_t = quint64;
-    buffersize_t bufferSize_ = 0;
+    //* socket device
+    QIODevice* device_ = nullptr;
 
-    //* buffer
+    //* received data, parsed in place
     QByteArray buffer_;
 
-    //* pending buffers
-    using BufferPair = QPair<quint32, QByteArray>;
-    QList<BufferPair> pendingBuffers_;
+    //* true while parsing received data
+    bool reading_ = false;
+
+    //* frames waiting to be written
+    QList<QByteArray> pendingFrames_;
+
+    //* true when pending frames are to be written in the next event loop iteration
+    bool flushScheduled_ = false;
 
 };
 
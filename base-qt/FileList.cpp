@@ -22,6 +22,9 @@
 #include "File.h"
 #include "Operators.h"
 
+#include <QSet>
+#include <QVector>
+
 #include <algorithm>
 
 //_______________________________________________
@@ -31,18 +34,43 @@ FileList::FileList( QObject* parent ):
     thread_( new ValidFileThread( this ) )
 {
     // thread connection
+    connect( thread_.get(), &ValidFileThread::partialRecordsAvailable, this, &FileList::_processPartialRecords );
     connect( thread_.get(), &ValidFileThread::recordsAvailable, this, &FileList::_processRecords );
 }
 
 //_______________________________________________
 bool FileList::contains( const File& file ) const
-{ return std::any_of( records_.begin(), records_.end(), FileRecord::SameFileFTorUnary( file ) ); }
+{
+    _checkIndex();
+    return index_.contains( file );
+}
 
 //_______________________________________________
 void FileList::remove( const File& file )
 {
     Debug::Throw() << "FileList::remove - " << file << Qt::endl;
-    records_.erase(std::remove_if( records_.begin(), records_.end(), FileRecord::SameFileFTorUnary( file ) ), records_.end() );
+
+    _checkIndex();
+    const auto iter( index_.find( file ) );
+    if( iter == index_.end() ) return;
+
+    const int position( iter.value().position );
+    timeIndex_.remove( iter.value().time, file );
+    index_.erase( iter );
+    touched_.remove( file );
+
+    // move last record in place of the removed one
+    // insertion order is not preserved. Users of the list sort records themselves
+    const int last( records_.size()-1 );
+    if( position != last )
+    {
+        records_[position] = records_[last];
+        const auto moved( index_.find( records_[position].file() ) );
+        if( moved != index_.end() && moved.value().position == last ) moved.value().position = position;
+    }
+
+    records_.removeLast();
+    _filesRemoved( { file } );
     return;
 }
 
@@ -51,7 +79,18 @@ void FileList::set( const FileRecord::List& records )
 {
 
     Debug::Throw( QStringLiteral("FileList::set.\n") );
-    records_ = records;
+
+    // skip duplicated files, so that each record is indexed
+    QSet<QString> files;
+    records_.clear();
+    for( const auto& record:records )
+    {
+        if( files.contains( record.file() ) ) continue;
+        files.insert( record.file() );
+        records_.append( record );
+    }
+
+    _updateIndex();
     emit contentsChanged();
 
 }
@@ -73,9 +112,16 @@ FileRecord FileList::lastValidFile()
 
     Debug::Throw( QStringLiteral("FileList::lastValidFile.\n") );
 
-    std::sort( records_.begin(), records_.end(), FileRecord::FirstOpenFTor() );
-    const auto iter = std::find_if( records_.rbegin(), records_.rend(), [this]( const FileRecord& record ) { return (!check_) || record.isValid(); } );
-    return iter == records_.rend() ? FileRecord():*iter;
+    // most recent valid record, from time index
+    _checkIndex();
+    for( auto&& iter = timeIndex_.constEnd(); iter != timeIndex_.constBegin(); )
+    {
+        --iter;
+        const auto& record( records_[index_.value( iter.value() ).position] );
+        if( !check_ || record.isValid() ) return record;
+    }
+
+    return FileRecord();
 }
 
 //_______________________________________________
@@ -88,13 +134,30 @@ void FileList::checkValidFiles()
     thread_->start();
 }
 
+//_______________________________________________
+void FileList::_processPartialRecords( const FileRecord::List& records )
+{
+    _checkIndex();
+    for( const auto& record:records )
+    {
+        const auto iter( index_.constFind( record.file() ) );
+        if( iter != index_.constEnd() ) records_[iter.value().position].setValid( record.isValid() );
+    }
+}
+
 //_______________________________________________
 void FileList::_processRecords( const FileRecord::List& records, bool hasInvalidRecords)
 {
 
+    // index validity by file. Records are only valid if the thread found them valid,
+    // rather than merely present in its output, so that missing and duplicated files are flagged
+    QSet<QString> validFiles;
+    for( const auto& record:records )
+    { if( record.isValid() ) validFiles.insert( record.file() ); }
+
     // set file records validity
     for( auto& record:records_ )
-    { record.setValid( std::any_of( records.begin(), records.end(), FileRecord::SameFileFTorUnary( record.file() ) ) ); }
+    { record.setValid( validFiles.contains( record.file() ) ); }
 
     _setCleanEnabled( hasInvalidRecords );
 
@@ -107,6 +170,11 @@ void FileList::clean()
 {
     Debug::Throw( QStringLiteral("FileList::clean") );
 
+    // removed files
+    File::List removed;
+    for( const auto& record:records_ )
+    { if( !( check_ && record.isValid() ) ) removed.append( record.file() ); }
+
     if( check_ )
     {
 
@@ -121,6 +189,8 @@ void FileList::clean()
 
     }
 
+    _updateIndex();
+    if( !removed.isEmpty() ) _filesRemoved( removed );
     return;
 }
 
@@ -128,7 +198,11 @@ void FileList::clean()
 void FileList::clear()
 {
     Debug::Throw( QStringLiteral("FileList::clear") );
+    File::List removed;
+    for( const auto& record:records_ ) removed.append( record.file() );
     records_.clear();
+    _updateIndex();
+    if( !removed.isEmpty() ) _filesRemoved( removed );
     return;
 }
 
@@ -149,15 +223,23 @@ FileRecord& FileList::_add(
     bool emitSignal )
 {
 
-    // do not add empty files
-    auto iter = std::find_if( records_.begin(), records_.end(), FileRecord::SameFileFTorUnary( record.file() ) );
-    if( iter != records_.end() )
+    _checkIndex();
+    const auto indexIter( index_.find( record.file() ) );
+    if( indexIter != index_.end() )
     {
 
+        auto iter = records_.begin() + indexIter.value().position;
+
         Debug::Throw() << "FileList::_add - updating: " << record.file() << Qt::endl;
         if( updateTimeStamp && iter->time() != record.time() )
         {
             iter->setTime( TimeStamp(qMax( iter->time(), record.time() ) ) );
+
+            // update time index
+            timeIndex_.remove( indexIter.value().time, record.file() );
+            indexIter.value().time = iter->time();
+            timeIndex_.insert( iter->time(), record.file() );
+
             if( emitSignal ) emit contentsChanged();
         }
 
@@ -166,6 +248,11 @@ FileRecord& FileList::_add(
     } else {
 
         Debug::Throw() << "FileList::_add - adding: " << record.file() << Qt::endl;
+        IndexEntry entry;
+        entry.position = records_.size();
+        entry.time = record.time();
+        index_.insert( record.file(), entry );
+        timeIndex_.insert( record.time(), record.file() );
         records_.append( record );
 
         if( emitSignal ) emit contentsChanged();
@@ -192,9 +279,79 @@ FileRecord::List FileList::_truncatedList( const FileRecord::List& constRecords
 
     }
 
-    // shrink list
+    // shrink list, keeping the most recent records in their original order
     if( maxSize_ > 0 && records.size() > maxSize_ )
-    { records.erase( records.begin(), records.begin() + (records.size() - maxSize_ )); }
+    {
+
+        QVector<TimeStamp> times;
+        times.reserve( records.size() );
+        for( const auto& record:records ) times.append( record.time() );
+
+        // find time of the oldest record to keep
+        const int removed = int( records.size() ) - maxSize_;
+        std::nth_element( times.begin(), times.begin() + removed, times.end() );
+        const auto threshold( times[removed] );
+
+        // records older than threshold are removed, as well as the first ones with matching time
+        int equalToRemove = int( std::count( times.begin(), times.begin() + removed, threshold ) );
+        records.erase( std::remove_if( records.begin(), records.end(), [&threshold, &equalToRemove]( const FileRecord& record )
+            {
+                if( record.time() < threshold ) return true;
+                else if( record.time() == threshold && equalToRemove > 0 ) { --equalToRemove; return true; }
+                else return false;
+            } ), records.end() );
+
+    }
 
     return records;
 }
+
+//___________________________________________________________________
+void FileList::_updateIndex() const
+{
+    index_.clear();
+    timeIndex_.clear();
+    touched_.clear();
+    indexDirty_ = false;
+
+    for( int index = 0; index < records_.size(); ++index )
+    {
+        // keep first occurrence for duplicated files
+        const auto& record( records_[index] );
+        if( index_.contains( record.file() ) ) continue;
+
+        IndexEntry entry;
+        entry.position = index;
+        entry.time = record.time();
+        index_.insert( record.file(), entry );
+        timeIndex_.insert( record.time(), record.file() );
+    }
+}
+
+//___________________________________________________________________
+void FileList::_checkIndex() const
+{
+
+    if( indexDirty_ )
+    {
+        _updateIndex();
+        return;
+    }
+
+    // update time of records for which a modifiable reference was returned
+    for( const auto& file:touched_ )
+    {
+        const auto iter( index_.find( file ) );
+        if( iter == index_.end() ) continue;
+
+        const auto& time( records_[iter.value().position].time() );
+        if( time == iter.value().time ) continue;
+
+        timeIndex_.remove( iter.value().time, file );
+        iter.value().time = time;
+        timeIndex_.insert( time, file );
+    }
+
+    touched_.clear();
+
+}
@@ -29,7 +29,10 @@
 #include "ValidFileThread.h"
 #include "base_qt_export.h"
 
+#include <QHash>
+#include <QMultiMap>
 #include <QObject>
+#include <QSet>
 
 //* handles list of files saved into resource file for later reopening
 class BASE_QT_EXPORT FileList: public QObject, private Base::Counter<FileList>
@@ -85,9 +88,13 @@ class BASE_QT_EXPORT FileList: public QObject, private Base::Counter<FileList>
     void remove( const File& );
 
     //* get filerecord associated to a name
-    /** creates new fileRecord if not found */
+    /** creates new fileRecord if not found. The record time can be modified through the returned reference */
     FileRecord& get( const File& file )
-    { return _add( FileRecord( file ), false ); }
+    {
+        auto& record( _add( FileRecord( file ), false ) );
+        touched_.insert( record.file() );
+        return record;
+    }
 
     //* set record
     void set( const FileRecord::List& );
@@ -110,7 +117,11 @@ class BASE_QT_EXPORT FileList: public QObject, private Base::Counter<FileList>
 
     //* add file.
     FileRecord& add( const File& file )
-    { return _add( FileRecord( file ) ); }
+    {
+        auto& record( _add( FileRecord( file ) ) );
+        touched_.insert( record.file() );
+        return record;
+    }
 
     //* run thread to check file validity
     void checkValidFiles();
@@ -145,11 +156,28 @@ class BASE_QT_EXPORT FileList: public QObject, private Base::Counter<FileList>
     { return records_; }
 
     //* list of files records
+    /** the file index is rebuilt when next used, since records can be modified through the returned reference */
     FileRecord::List& _records()
-    { return records_; }
+    {
+        indexDirty_ = true;
+        return records_;
+    }
+
+    //* called when files are removed from the list
+    virtual void _filesRemoved( const File::List& )
+    {}
 
     private:
 
+    //* rebuild file index from records
+    void _updateIndex() const;
+
+    //* make sure file index is up to date
+    void _checkIndex() const;
+
+    //* process partial records from threads
+    void _processPartialRecords( const FileRecord::List& );
+
     //* process records from threads
     void _processRecords( const FileRecord::List&, bool );
 
@@ -169,8 +197,33 @@ class BASE_QT_EXPORT FileList: public QObject, private Base::Counter<FileList>
     //* thread to check file validity
     std::unique_ptr<ValidFileThread, Base::ThreadDeleter> thread_;
 
-    //* current list of files
+    //* current list of files, in insertion order
     FileRecord::List records_;
 
+    //* file index entry
+    class IndexEntry
+    {
+        public:
+
+        //* position in list
+        int position = 0;
+
+        //* record time, when indexed
+        TimeStamp time;
+
+    };
+
+    //* position and time of records in list, indexed by file
+    mutable QHash<QString, IndexEntry> index_;
+
+    //* files, indexed by record time
+    mutable QMultiMap<TimeStamp, QString> timeIndex_;
+
+    //* files for which a modifiable reference was returned, and whose time must be checked
+    mutable QSet<QString> touched_;
+
+    //* true if records were modified directly, and index must be rebuilt
+    mutable bool indexDirty_ = false;
+
 };
 #endif
@@ -19,6 +19,211 @@
 
 #include "FileSystemWatcher.h"
 
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPair>
+#include <QSocketNotifier>
+
+#if defined(Q_OS_LINUX)
+#include <sys/inotify.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    #if defined(Q_OS_LINUX)
+    //* events monitored for directories
+    static const uint32_t directoryMask =
+        IN_CREATE|IN_DELETE|IN_MODIFY|IN_ATTRIB|IN_CLOSE_WRITE|
+        IN_MOVED_FROM|IN_MOVED_TO|IN_DELETE_SELF|IN_MOVE_SELF|IN_ONLYDIR;
+
+    //* events monitored for files
+    static const uint32_t fileMask =
+        IN_MODIFY|IN_ATTRIB|IN_CLOSE_WRITE|IN_DELETE_SELF|IN_MOVE_SELF;
+    #endif
+
+    //* poll interval for directories that could not be watched (ms)
+    static const int pollInterval = 2000;
+
+    //* sub-directories to be watched recursively
+    QFileInfoList subDirectories( const QString& path )
+    { return QDir( path ).entryInfoList( QDir::Dirs|QDir::NoDotAndDotDot|QDir::Hidden|QDir::NoSymLinks ); }
+
+    //* directory modification time, in milliseconds, or -1 if missing
+    qint64 modificationTime( const QString& path )
+    {
+        const QFileInfo info( path );
+        return ( info.exists() && info.lastModified().isValid() ) ? info.lastModified().toMSecsSinceEpoch():-1;
+    }
+
+}
+
+//___________________________________________________
+FileSystemWatcher::FileSystemWatcher( QObject* parent ):
+    QFileSystemWatcher( parent ),
+    Counter( QStringLiteral("FileSystemWatcher") )
+{
+    Debug::Throw( QStringLiteral("FileSystemWatcher::FileSystemWatcher.\n") );
+    clock_.start();
+
+    #if defined(Q_OS_LINUX)
+    descriptor_ = inotify_init1( IN_NONBLOCK|IN_CLOEXEC );
+    if( descriptor_ >= 0 )
+    {
+        notifier_ = new QSocketNotifier( descriptor_, QSocketNotifier::Read, this );
+        connect( notifier_, &QSocketNotifier::activated, this, &FileSystemWatcher::_readEvents );
+        return;
+    }
+    #endif
+
+    // fallback to base class
+    connect( this, &QFileSystemWatcher::directoryChanged, this, [this]( const QString& directory )
+    {
+        emit directoryChanged( directory );
+        _addModifiedDirectory( directory, directory );
+    } );
+
+    connect( this, &QFileSystemWatcher::fileChanged, this, [this]( const QString& file ) { emit fileChanged( file ); } );
+
+}
+
+//___________________________________________________
+FileSystemWatcher::~FileSystemWatcher()
+{
+    #if defined(Q_OS_LINUX)
+    if( descriptor_ >= 0 )
+    {
+        delete notifier_;
+        ::close( descriptor_ );
+    }
+    #endif
+}
+
+//___________________________________________________
+QStringList FileSystemWatcher::directories() const
+{
+    if( descriptor_ < 0 ) return QFileSystemWatcher::directories();
+
+    QStringList out;
+    for( const auto& watch:watches_ )
+    { if( watch.isDirectory && watch.parent < 0 ) out.append( watch.path ); }
+
+    return out;
+}
+
+//___________________________________________________
+QStringList FileSystemWatcher::files() const
+{
+    if( descriptor_ < 0 ) return QFileSystemWatcher::files();
+
+    QStringList out;
+    for( const auto& watch:watches_ )
+    { if( !watch.isDirectory ) out.append( watch.path ); }
+
+    return out;
+}
+
+//___________________________________________________
+bool FileSystemWatcher::addPath( const QString& path, bool recursive )
+{
+
+    Debug::Throw() << "FileSystemWatcher::addPath - " << path << " recursive: " << recursive << Qt::endl;
+    if( path.isEmpty() ) return false;
+
+    const QFileInfo info( path );
+    if( descriptor_ < 0 )
+    {
+
+        if( !( recursive && info.isDir() ) ) return QFileSystemWatcher::addPath( path );
+
+        // sub-directories are added once. They are not tracked afterwards
+        QStringList directories( { path } );
+        for( int index = 0; index < directories.size(); ++index )
+        {
+            for( const auto& child:subDirectories( directories[index] ) )
+            { directories.append( child.absoluteFilePath() ); }
+        }
+
+        const auto failed( QFileSystemWatcher::addPaths( directories ) );
+        if( failed.contains( path ) ) return false;
+
+        // sub-directories that could not be added are polled
+        bool added( false );
+        for( const auto& directory:failed )
+        { added |= _addUnwatched( directory, path ); }
+
+        if( added ) emit watchLimitReached( path );
+        return failed.isEmpty();
+
+    }
+
+    #if defined(Q_OS_LINUX)
+    if( watchDescriptors_.contains( path ) || !info.exists() ) return false;
+    if( recursive && info.isDir() ) return _addRecursive( path, path, -1 );
+
+    const int watchDescriptor = inotify_add_watch( descriptor_, QFile::encodeName( path ).constData(), info.isDir() ? directoryMask:fileMask );
+    if( watchDescriptor < 0 || watches_.contains( watchDescriptor ) ) return false;
+
+    Watch watch;
+    watch.path = path;
+    watch.root = path;
+    watch.isDirectory = info.isDir();
+    watches_.insert( watchDescriptor, watch );
+    watchDescriptors_.insert( path, watchDescriptor );
+    return true;
+    #else
+    return false;
+    #endif
+
+}
+
+//___________________________________________________
+QStringList FileSystemWatcher::addPaths( const QStringList& paths, bool recursive )
+{
+    QStringList out;
+    for( const auto& path:paths )
+    { if( !addPath( path, recursive ) ) out.append( path ); }
+    return out;
+}
+
+//___________________________________________________
+bool FileSystemWatcher::removePath( const QString& path )
+{
+
+    Debug::Throw() << "FileSystemWatcher::removePath - " << path << Qt::endl;
+
+    // unwatched sub-directories
+    for( auto&& iter = unwatched_.begin(); iter != unwatched_.end(); )
+    {
+        if( iter.value().root == path ) iter = unwatched_.erase( iter );
+        else ++iter;
+    }
+
+    if( unwatched_.isEmpty() ) pollTimer_.stop();
+    if( descriptor_ < 0 ) return QFileSystemWatcher::removePath( path );
+
+    // sub-directories of recursive watches cannot be removed individually
+    auto iter( watchDescriptors_.find( path ) );
+    if( iter == watchDescriptors_.end() || watches_.value( iter.value() ).parent >= 0 ) return false;
+
+    _removeRecursive( iter.value() );
+    return true;
+
+}
+
+//___________________________________________________
+QStringList FileSystemWatcher::removePaths( const QStringList& paths )
+{
+    QStringList out;
+    for( const auto& path:paths )
+    { if( !removePath( path ) ) out.append( path ); }
+    return out;
+}
+
 //___________________________________________________
 void FileSystemWatcher::timerEvent( QTimerEvent* event )
 {
@@ -26,28 +231,422 @@ void FileSystemWatcher::timerEvent( QTimerEvent* event )
     {
 
         Debug::Throw(QStringLiteral("FileSystemWatcher::timerEvent.\n") );
-
         timer_.stop();
-        for( const auto& directory:directories_ )
+
+        // collect due changes
+        const qint64 now( clock_.elapsed() );
+        qint64 next = -1;
+        ChangeSet changes;
+        for( auto&& iter = pending_.begin(); iter != pending_.end(); )
+        {
+
+            const auto& pending( iter.value() );
+            const qint64 due( pending.due() );
+            if( due > now )
+            {
+                next = next < 0 ? due : qMin( next, due );
+                ++iter;
+                continue;
+            }
+
+            if( pending.rescan ) changes.rescan.insert( iter.key() );
+            else if( !pending.entries.isEmpty() ) {
+
+                Event::List events;
+                for( auto&& entryIter = pending.entries.begin(); entryIter != pending.entries.end(); ++entryIter )
+                {
+                    Event entry;
+                    entry.type = entryIter.value();
+                    entry.name = entryIter.key();
+                    events.append( entry );
+                }
+
+                changes.events.insert( iter.key(), events );
+
+            }
+
+            iter = pending_.erase( iter );
+
+        }
+
+        // reschedule before emitting, since slots might modify the watched paths
+        if( next >= 0 ) _schedule( next );
+        if( changes.isEmpty() ) return;
+
+        emit changesAvailable( changes );
+
+        for( const auto& directory:changes.rescan )
         { emit directoryChangedDelayed( directory ); }
 
-        directories_.clear();
+        for( auto&& iter = changes.events.begin(); iter != changes.events.end(); ++iter )
+        { emit directoryChangedDelayed( iter.key() ); }
+
+    } else if( event->timerId() == pollTimer_.timerId() ) {
+
+        _pollUnwatched();
+        if( unwatched_.isEmpty() ) pollTimer_.stop();
 
     } else QFileSystemWatcher::timerEvent( event );
 
 }
 
 //___________________________________________________
-void FileSystemWatcher::_addModifiedDirectory( const QString& directory )
+FileSystemWatcher::Pending& FileSystemWatcher::_pending( const QString& directory, const QString& root )
 {
 
-    if( directories_.contains( directory ) ) return;
+    const qint64 now( clock_.elapsed() );
+    auto iter( pending_.find( directory ) );
+    if( iter == pending_.end() )
+    {
+        Pending pending;
+        pending.policy = policies_.value( root, defaultPolicy_ );
+        pending.first = now;
+        iter = pending_.insert( directory, pending );
+    }
+
+    iter.value().last = now;
+    _schedule( iter.value().due() );
+    return iter.value();
+
+}
+
+//___________________________________________________
+void FileSystemWatcher::_schedule( qint64 due )
+{
+    if( timer_.isActive() && scheduled_ <= due ) return;
+    scheduled_ = due;
+    timer_.start( int( qMax<qint64>( 0, due - clock_.elapsed() ) ), this );
+}
+
+//___________________________________________________
+void FileSystemWatcher::_addModifiedDirectory( const QString& directory, const QString& root )
+{
 
-    // append to directory list
     Debug::Throw() << "FileSystemWatcher::_addModifiedDirectory - " << directory << Qt::endl;
-    directories_.append( directory );
+    auto& pending( _pending( directory, root ) );
+    pending.rescan = true;
+    pending.entries.clear();
+
+}
+
+//___________________________________________________
+void FileSystemWatcher::_addEvent( const QString& directory, const QString& root, Event::Type type, const QString& name )
+{
+
+    auto& pending( _pending( directory, root ) );
+    if( pending.rescan ) return;
+
+    auto& entryMap( pending.entries );
+    auto iter( entryMap.find( name ) );
+    if( iter == entryMap.end() ) entryMap.insert( name, type );
+    else if( iter.value() == Event::Type::Created ) {
+
+        // transient entry
+        if( type == Event::Type::Removed ) entryMap.erase( iter );
+
+    } else if( iter.value() == Event::Type::Removed ) {
+
+        // entry replaced
+        if( type == Event::Type::Created ) iter.value() = Event::Type::Modified;
+
+    } else if( type == Event::Type::Removed ) iter.value() = type;
+
+}
+
+//___________________________________________________
+void FileSystemWatcher::_readEvents()
+{
+
+    #if defined(Q_OS_LINUX)
+    alignas( struct inotify_event ) char buffer[16384];
+    forever
+    {
+
+        const ssize_t length = ::read( descriptor_, buffer, sizeof( buffer ) );
+        if( length <= 0 ) break;
+
+        for( const char* current = buffer; current < buffer + length; )
+        {
+
+            const auto event = reinterpret_cast<const struct inotify_event*>( current );
+            current += sizeof( struct inotify_event ) + event->len;
+
+            // events were lost. Rescan all watched directories
+            if( event->mask & IN_Q_OVERFLOW )
+            {
+
+                Debug::Throw(0) << "FileSystemWatcher::_readEvents - event queue overflow" << Qt::endl;
+
+                QList<Watch> roots;
+                for( const auto& watch:watches_ )
+                { if( watch.isDirectory && watch.parent < 0 ) roots.append( watch ); }
+
+                for( const auto& watch:roots )
+                {
+                    // also add watches for sub-directories created in the meantime
+                    if( watch.recursive ) _addRecursive( watch.path, watch.root, -1 );
+                    _addModifiedDirectory( watch.path, watch.root );
+                }
+
+                continue;
+
+            }
+
+            auto iter( watches_.find( event->wd ) );
+            if( iter == watches_.end() ) continue;
+
+            // watch removed by the kernel
+            if( event->mask & IN_IGNORED )
+            {
+                _removeWatch( event->wd );
+                continue;
+            }
+
+            const Watch watch( iter.value() );
+            if( !watch.isDirectory )
+            {
+                emit fileChanged( watch.path );
+                continue;
+            }
+
+            emit directoryChanged( watch.path );
+
+            // directory itself removed or moved. Sub-directories are handled by their parent
+            if( event->mask & (IN_DELETE_SELF|IN_MOVE_SELF) )
+            {
+                if( watch.parent < 0 ) _addModifiedDirectory( watch.path, watch.root );
+                continue;
+            }
+
+            // changes to the directory itself
+            if( !event->len ) continue;
+
+            // moves are reported as removal from the source and creation in the destination
+            const QString name( QFile::decodeName( event->name ) );
+            const bool isDirectory( event->mask & IN_ISDIR );
+            if( event->mask & (IN_CREATE|IN_MOVED_TO) )
+            {
+
+                _addEvent( watch.path, watch.root, Event::Type::Created, name );
+                if( watch.recursive && isDirectory )
+                {
+                    // entries might have been created before the watch was added
+                    const QString path( QFileInfo( QDir( watch.path ), name ).absoluteFilePath() );
+                    if( !_addRecursive( path, watch.root, event->wd ) )
+                    { Debug::Throw(0) << "FileSystemWatcher::_readEvents - cannot watch " << path << " recursively" << Qt::endl; }
+
+                    _addModifiedDirectory( path, watch.root );
+                }
+
+            } else if( event->mask & (IN_DELETE|IN_MOVED_FROM) ) {
+
+                _addEvent( watch.path, watch.root, Event::Type::Removed, name );
+                if( watch.recursive && isDirectory )
+                {
+                    const QString path( QFileInfo( QDir( watch.path ), name ).absoluteFilePath() );
+                    const auto childIter( watchDescriptors_.find( path ) );
+                    if( childIter != watchDescriptors_.end() && watches_.value( childIter.value() ).parent >= 0 )
+                    { _removeRecursive( childIter.value() ); }
+                }
+
+            } else _addEvent( watch.path, watch.root, Event::Type::Modified, name );
+
+        }
+
+    }
+    #endif
+
+}
+
+//___________________________________________________
+bool FileSystemWatcher::_addRecursive( const QString& path, const QString& root, int parent )
+{
+
+    #if defined(Q_OS_LINUX)
+    // iterative, to support deep trees
+    QList<QPair<QString, int>> directories( { qMakePair( path, parent ) } );
+    bool added( false );
+    while( !directories.isEmpty() )
+    {
+
+        const auto current( directories.takeLast() );
+
+        int watchDescriptor = -1;
+        auto iter( watchDescriptors_.find( current.first ) );
+        if( iter != watchDescriptors_.end() ) watchDescriptor = iter.value();
+        else {
+
+            watchDescriptor = inotify_add_watch( descriptor_, QFile::encodeName( current.first ).constData(), directoryMask );
+            if( watchDescriptor < 0 )
+            {
+
+                const int error = errno;
+                Debug::Throw(0) << "FileSystemWatcher::_addRecursive - cannot watch " << current.first << ": " << strerror( error ) << Qt::endl;
+
+                // root not readable
+                if( current.first == path && error != ENOSPC ) return false;
+
+                // watch limit reached. Remaining directories are polled
+                if( error == ENOSPC )
+                {
+                    added |= _addUnwatched( current.first, root );
+                    for( const auto& directory:directories )
+                    { added |= _addUnwatched( directory.first, root ); }
+
+                    if( added ) emit watchLimitReached( root );
+                    return false;
+                }
+
+                continue;
+
+            }
+
+            // same directory reached through another path
+            if( watches_.contains( watchDescriptor ) ) continue;
+
+            Watch watch;
+            watch.path = current.first;
+            watch.root = root;
+            watch.parent = current.second;
+            watch.isDirectory = true;
+            watch.recursive = true;
+            watches_.insert( watchDescriptor, watch );
+            watchDescriptors_.insert( current.first, watchDescriptor );
+            if( current.second >= 0 ) children_[current.second].insert( watchDescriptor );
+
+            // changes might have been missed while the directory was not watched
+            if( unwatched_.remove( current.first ) ) _addModifiedDirectory( current.first, root );
+
+        }
+
+        for( const auto& child:subDirectories( current.first ) )
+        { directories.append( qMakePair( child.absoluteFilePath(), watchDescriptor ) ); }
+
+    }
+
+    return true;
+    #else
+    Q_UNUSED( path );
+    Q_UNUSED( root );
+    Q_UNUSED( parent );
+    return false;
+    #endif
+
+}
+
+//___________________________________________________
+void FileSystemWatcher::_removeRecursive( int watchDescriptor )
+{
+
+    // collect sub-directories
+    QList<int> watchDescriptors( { watchDescriptor } );
+    for( int index = 0; index < watchDescriptors.size(); ++index )
+    {
+        for( const auto& child:children_.value( watchDescriptors[index] ) )
+        { watchDescriptors.append( child ); }
+    }
+
+    // remove, children first
+    for( auto&& iter = watchDescriptors.rbegin(); iter != watchDescriptors.rend(); ++iter )
+    {
+        #if defined(Q_OS_LINUX)
+        inotify_rm_watch( descriptor_, *iter );
+        #endif
+        _removeWatch( *iter );
+    }
+
+}
+
+//___________________________________________________
+void FileSystemWatcher::_removeWatch( int watchDescriptor )
+{
+
+    auto iter( watches_.find( watchDescriptor ) );
+    if( iter == watches_.end() ) return;
+
+    const auto& watch( iter.value() );
+    if( watch.parent >= 0 )
+    {
+        auto parentIter( children_.find( watch.parent ) );
+        if( parentIter != children_.end() )
+        {
+            parentIter.value().remove( watchDescriptor );
+            if( parentIter.value().isEmpty() ) children_.erase( parentIter );
+        }
+    }
+
+    children_.remove( watchDescriptor );
+    watchDescriptors_.remove( watch.path );
+    pending_.remove( watch.path );
+    watches_.erase( iter );
+
+}
+
+//___________________________________________________
+bool FileSystemWatcher::_addUnwatched( const QString& path, const QString& root )
+{
+
+    if( unwatched_.contains( path ) ) return false;
+
+    Debug::Throw() << "FileSystemWatcher::_addUnwatched - " << path << Qt::endl;
+    Unwatched unwatched;
+    unwatched.root = root;
+    unwatched.modified = modificationTime( path );
+    unwatched_.insert( path, unwatched );
+
+    if( !pollTimer_.isActive() ) pollTimer_.start( pollInterval, this );
+    return true;
+
+}
+
+//___________________________________________________
+void FileSystemWatcher::_pollUnwatched()
+{
+
+    Debug::Throw() << "FileSystemWatcher::_pollUnwatched - directories: " << unwatched_.size() << Qt::endl;
+    for( const auto& path:unwatched_.keys() )
+    {
+
+        // might have been watched while processing a parent directory
+        auto iter( unwatched_.find( path ) );
+        if( iter == unwatched_.end() ) continue;
+
+        // removed directories are reported by their parent
+        const QString root( iter.value().root );
+        const qint64 modified( modificationTime( path ) );
+        if( modified < 0 )
+        {
+            unwatched_.erase( iter );
+            continue;
+        }
+
+        if( modified != iter.value().modified )
+        {
+            iter.value().modified = modified;
+            _addModifiedDirectory( path, root );
+        }
+
+        // try watch again
+        if( descriptor_ < 0 )
+        {
+
+            if( QFileSystemWatcher::addPath( path ) )
+            {
+                unwatched_.remove( path );
+                _addModifiedDirectory( path, root );
+            }
+
+        } else {
+
+            #if defined(Q_OS_LINUX)
+            // directories whose parent is not watched either are handled together with their parent
+            if( unwatched_.contains( QFileInfo( path ).absolutePath() ) ) continue;
+            const int parent( watchDescriptors_.value( QFileInfo( path ).absolutePath(), -1 ) );
+            _addRecursive( path, root, parent );
+            #endif
+
+        }
 
-    // restart timer
-    if( !timer_.isActive() ) timer_.start( delay_, this );
+    }
 
 }
@@ -25,10 +25,30 @@
 #include "base_qt_export.h"
 
 #include <QBasicTimer>
+#include <QElapsedTimer>
 #include <QFileSystemWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
 #include <QStringList>
 #include <QTimerEvent>
 
+class QSocketNotifier;
+
+//* file system watcher
+/**
+on linux, paths are monitored directly using inotify, which allows to report
+which entries of a watched directory have been created, removed or modified.
+Directories can be watched recursively, in which case watches are added and removed
+automatically as sub-directories appear and disappear.
+Events are debounced per directory and emitted in batches.
+When the watch limit is reached, directories that could not be watched are reported using watchLimitReached,
+and polled until watches become available again. Changes to their modification time trigger a rescan.
+On other platforms, the QFileSystemWatcher base class is used, and only modified directories are reported.
+The path accessors and modifiers, as well as the directoryChanged and fileChanged signals, hide the ones
+of the base class. Paths added through a QFileSystemWatcher pointer are monitored by the base class only
+*/
 class BASE_QT_EXPORT FileSystemWatcher: public QFileSystemWatcher, private Base::Counter<FileSystemWatcher>
 {
     Q_OBJECT
@@ -36,23 +56,150 @@ class BASE_QT_EXPORT FileSystemWatcher: public QFileSystemWatcher, private Base:
     public:
 
     //* constructor
-    explicit FileSystemWatcher( QObject* parent = nullptr ):
-        QFileSystemWatcher( parent ),
-        Counter( QStringLiteral("FileSystemWatcher") )
+    explicit FileSystemWatcher( QObject* = nullptr );
+
+    //* destructor
+    ~FileSystemWatcher() override;
+
+    //* entry event
+    class BASE_QT_EXPORT Event
+    {
+
+        public:
+
+        //* event type
+        enum class Type
+        {
+            Created,
+            Removed,
+            Modified
+        };
+
+        //* type
+        Type type = Type::Modified;
+
+        //* entry name, relative to the watched directory
+        QString name;
+
+        //* list
+        using List = QList<Event>;
+
+    };
+
+    //* changes, emitted in batches
+    class BASE_QT_EXPORT ChangeSet
     {
-        Debug::Throw( QStringLiteral("FileSystemWatcher::FileSystemWatcher.\n") );
-        connect( this, &QFileSystemWatcher::directoryChanged, this, &FileSystemWatcher::_addModifiedDirectory );
-    }
 
-    //* delay
+        public:
+
+        //* true if empty
+        bool isEmpty() const
+        { return events.isEmpty() && rescan.isEmpty(); }
+
+        //* entry events, per directory
+        QHash<QString, Event::List> events;
+
+        //* directories for which changes are unknown and must be listed again
+        /** for recursive watches, only the root directory is reported after an event queue overflow */
+        QSet<QString> rescan;
+
+    };
+
+    //* debounce policy
+    /**
+    changes to a directory are emitted once no new event was received for delay milliseconds,
+    and at most maximumDelay milliseconds after the first event
+    */
+    class BASE_QT_EXPORT DebouncePolicy
+    {
+
+        public:
+
+        //* constructor
+        explicit DebouncePolicy( int delay = 500, int maximumDelay = 500 ):
+            delay( delay ),
+            maximumDelay( maximumDelay )
+        {}
+
+        //* delay
+        int delay = 500;
+
+        //* maximum delay
+        int maximumDelay = 500;
+
+    };
+
+    //*@name accessors
+    //@{
+
+    //* true if per-entry events are available
+    bool hasEntryEvents() const
+    { return descriptor_ >= 0; }
+
+    //* watched directories
+    /** sub-directories added automatically for recursive watches are not reported */
+    QStringList directories() const;
+
+    //* watched files
+    QStringList files() const;
+
+    //* number of inotify watches
+    int watchCount() const
+    { return watches_.size(); }
+
+    //* directories that could not be watched, and are polled instead
+    QStringList unwatchedDirectories() const
+    { return unwatched_.keys(); }
+
+    //@}
+
+    //*@name modifiers
+    //@{
+
+    //* default delay
     void setDelay( int value )
-    { delay_ = value; }
+    { defaultPolicy_ = DebouncePolicy( value, value ); }
+
+    //* default debounce policy
+    void setDebouncePolicy( const DebouncePolicy& policy )
+    { defaultPolicy_ = policy; }
+
+    //* debounce policy for a given watched path
+    void setDebouncePolicy( const QString& path, const DebouncePolicy& policy )
+    { policies_.insert( path, policy ); }
+
+    //* add path
+    /** for recursive watches, returns false if the path or any of its sub-directories could not be watched */
+    bool addPath( const QString&, bool recursive = false );
+
+    //* add paths
+    QStringList addPaths( const QStringList&, bool recursive = false );
+
+    //* remove path
+    bool removePath( const QString& );
+
+    //* remove paths
+    QStringList removePaths( const QStringList& );
+
+    //@}
 
     Q_SIGNALS:
 
+    //* file changed
+    void fileChanged( const QString& );
+
+    //* directory changed, emitted for every change, without delay
+    void directoryChanged( const QString& );
+
     //* delayed directory changed signal
     void directoryChangedDelayed( const QString& );
 
+    //* batched changes
+    void changesAvailable( const FileSystemWatcher::ChangeSet& );
+
+    //* emitted when some sub-directories of a watched path could not be watched, because the watch limit is reached
+    void watchLimitReached( const QString& );
+
     protected:
 
     //* timer event
@@ -60,18 +207,144 @@ class BASE_QT_EXPORT FileSystemWatcher: public QFileSystemWatcher, private Base:
 
     private:
 
-    //* add modified directory
-    void _addModifiedDirectory( const QString& );
+    //* pending events, per entry name
+    using EntryMap = QHash<QString, Event::Type>;
+
+    //* pending changes for a given directory
+    class Pending
+    {
+        public:
+
+        //* time at which changes are to be emitted
+        qint64 due() const
+        { return qMin( last + policy.delay, first + policy.maximumDelay ); }
+
+        //* policy
+        DebouncePolicy policy;
+
+        //* first event time
+        qint64 first = 0;
+
+        //* last event time
+        qint64 last = 0;
+
+        //* true if the directory must be listed again
+        bool rescan = false;
+
+        //* entry events
+        EntryMap entries;
+
+    };
+
+    //* find or create pending changes for a directory and schedule emission
+    Pending& _pending( const QString& directory, const QString& root );
+
+    //* schedule timer
+    void _schedule( qint64 );
+
+    //* add modified directory, given the watched root
+    void _addModifiedDirectory( const QString&, const QString& );
 
-    //* delay
-    int delay_ = 500;
+    //* add entry event
+    void _addEvent( const QString&, const QString&, Event::Type, const QString& );
 
-    //* modified directories
-    QStringList directories_;
+    //* read inotify events
+    void _readEvents();
+
+    //* add watches for a directory and its sub-directories. Returns false on error
+    bool _addRecursive( const QString&, const QString&, int );
+
+    //* remove a watch and its sub-directories
+    void _removeRecursive( int );
+
+    //* remove a watch from internal indices
+    void _removeWatch( int );
+
+    //* add directory that could not be watched, given the watched root. Returns true if new
+    bool _addUnwatched( const QString&, const QString& );
+
+    //* poll directories that could not be watched
+    void _pollUnwatched();
+
+    //* default policy
+    DebouncePolicy defaultPolicy_;
+
+    //* policies, per watched path
+    QHash<QString, DebouncePolicy> policies_;
 
     //* timer
     QBasicTimer timer_;
 
+    //* time at which the timer is due
+    qint64 scheduled_ = 0;
+
+    //* monotonic clock
+    QElapsedTimer clock_;
+
+    //*@name inotify
+    //@{
+
+    //* inotify file descriptor
+    int descriptor_ = -1;
+
+    //* notifier
+    QSocketNotifier* notifier_ = nullptr;
+
+    //* watch
+    class Watch
+    {
+        public:
+
+        //* path
+        QString path;
+
+        //* path passed to addPath, for recursive watches
+        QString root;
+
+        //* parent watch descriptor, for sub-directories of recursive watches
+        int parent = -1;
+
+        //* true if directory
+        bool isDirectory = false;
+
+        //* true if recursive
+        bool recursive = false;
+
+    };
+
+    //* watches, indexed by watch descriptor
+    QHash<int, Watch> watches_;
+
+    //* watch descriptors, indexed by path
+    QHash<QString, int> watchDescriptors_;
+
+    //* sub-directory watches, indexed by parent watch descriptor
+    QHash<int, QSet<int>> children_;
+
+    //@}
+
+    //* pending changes, per directory
+    QHash<QString, Pending> pending_;
+
+    //* directory that could not be watched
+    class Unwatched
+    {
+        public:
+
+        //* watched root
+        QString root;
+
+        //* modification time, in milliseconds
+        qint64 modified = -1;
+
+    };
+
+    //* directories that could not be watched, indexed by path
+    QHash<QString, Unwatched> unwatched_;
+
+    //* poll timer
+    QBasicTimer pollTimer_;
+
 };
 
 #endif
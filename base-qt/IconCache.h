@@ -21,6 +21,7 @@
 *******************************************************************************/
 
 #include "Counter.h"
+#include "LruCache.h"
 #include "base_qt_export.h"
 
 #include <QString>
@@ -77,6 +78,15 @@ namespace Base
         const QStringList& files() const
         { return files_; }
 
+        //* approximate memory used by the icon pixmaps, in bytes
+        qint64 cost() const
+        {
+            qint64 out = 0;
+            for( const auto& size:availableSizes() )
+            { out += qint64( size.width() )*size.height()*4; }
+            return out;
+        }
+
         //@}
 
         //*@name modifiers
@@ -107,7 +117,7 @@ namespace Base
     };
 
     //* cache
-    using IconCache = QHash<QString, IconCacheItem>;
+    using IconCache = LruCache<QString, IconCacheItem>;
     using IconPair =  QPair<QString, IconCacheItem >;
 
     inline bool operator == ( const IconPair& first, const IconPair& second )
@@ -19,12 +19,14 @@
 
 #include "IconCacheDialog.h"
 #include "BaseIconNames.h"
+#include "File.h"
 #include "IconEngine.h"
 #include "IconSize.h"
 #include "QtUtil.h"
 #include "TreeView.h"
 
 
+#include <QLabel>
 #include <QPushButton>
 #include <QLayout>
 
@@ -48,6 +50,11 @@ IconCacheDialog::IconCacheDialog( QWidget* parent ):
 
     QtUtil::setWidgetSides(list_, Qt::TopEdge|Qt::BottomEdge);
 
+    // statistics
+    statisticsLabel_ = new QLabel( this );
+    QtUtil::setMargin( statisticsLabel_, defaultMargin() );
+    mainLayout().addWidget( statisticsLabel_ );
+
     QPushButton *button;
     buttonLayout().insertWidget( 1, button = new QPushButton( IconEngine::get( IconNames::Reload ), tr( "Update" ), this ) );
     connect( button, &QPushButton::clicked, this, [this](bool){ updateCache(); } );
@@ -64,11 +71,20 @@ void IconCacheDialog::updateCache()
     // retrieve cache
     const Base::IconCache& cache( IconEngine::cache() );
     IconCacheModel::List modelList;
-    for( auto&& iter = cache.begin(); iter != cache.end(); ++iter )
-    { modelList.append( Base::IconPair( iter.key(), iter.value() ) ); }
+    for( const auto& key:cache.keys() )
+    { modelList.append( Base::IconPair( key, *cache.peek( key ) ) ); }
 
     model_.set( modelList );
 
     list_->resizeColumnToContents( IconCacheModel::Icon );
 
+    // statistics
+    const auto& statistics( cache.statistics() );
+    statisticsLabel_->setText( tr( "Icons: %1 - Memory: %2 of %3 - Hits: %4 - Misses: %5 - Evictions: %6" )
+        .arg( cache.size() )
+        .arg( File::sizeString( cache.totalCost() ), File::sizeString( cache.maxCost() ) )
+        .arg( statistics.hits )
+        .arg( statistics.misses )
+        .arg( statistics.evictions ) );
+
 }
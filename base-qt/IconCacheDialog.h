@@ -25,6 +25,7 @@
 #include "IconCacheModel.h"
 #include "base_qt_export.h"
 
+class QLabel;
 class TreeView;
 
 //* displays IconCache names and counts
@@ -50,6 +51,9 @@ class BASE_QT_EXPORT IconCacheDialog: public Dialog
     //* list
     TreeView* list_ = nullptr;
 
+    //* statistics
+    QLabel* statisticsLabel_ = nullptr;
+
 };
 
 #endif
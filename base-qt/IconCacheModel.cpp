@@ -18,6 +18,7 @@
 *******************************************************************************/
 
 #include "IconCacheModel.h"
+#include "File.h"
 
 //__________________________________________________________________
 QVariant IconCacheModel::data( const QModelIndex& index, int role ) const
@@ -37,6 +38,7 @@ QVariant IconCacheModel::data( const QModelIndex& index, int role ) const
             case Icon: return iconPair.first;
             case Files: return iconPair.second.files().join( QStringLiteral("\n") );
             case Sizes: return _availableSizes( iconPair );
+            case Memory: return File::sizeString( iconPair.second.cost() );
 
             default: break;
         }
@@ -95,6 +97,7 @@ bool IconCacheModel::SortFTor::operator () ( Base::IconPair first, Base::IconPai
         case Icon: return first.first < second.first;
         case Files: return first.second.files().join( QLatin1String("") ) < second.second.files().join( QLatin1String("") );
         case Sizes: return _availableSizes( first ) < _availableSizes( second );
+        case Memory: return first.second.cost() < second.second.cost();
         default: return true;
     }
 
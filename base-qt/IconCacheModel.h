@@ -42,6 +42,7 @@ class BASE_QT_EXPORT IconCacheModel: public ListModel<Base::IconPair>, private B
         Icon,
         Files,
         Sizes,
+        Memory,
         nColumns
     };
 
@@ -98,7 +99,8 @@ class BASE_QT_EXPORT IconCacheModel: public ListModel<Base::IconPair>, private B
     {{
         tr( "Icon" ),
         tr( "Files" ),
-        tr( "Available Sizes" )
+        tr( "Available Sizes" ),
+        tr( "Memory" )
     }};
 
 };
@@ -0,0 +1,223 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "IconDecoder.h"
+#include "BaseFileIconProvider.h"
+#include "BaseFileInfo.h"
+#include "BaseIconNames.h"
+#include "Debug.h"
+#include "PixmapPathIndex.h"
+
+#include <QMetaObject>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+//__________________________________________________________
+IconDecoder::IconDecoder( QObject* parent, int threadCount ):
+    QObject( parent ),
+    Counter( QStringLiteral("IconDecoder") )
+{
+    Debug::Throw( QStringLiteral("IconDecoder::IconDecoder.\n") );
+    for( int i = 0; i < qMax( 1, threadCount ); ++i )
+    {
+        threads_.emplace_back( new Thread( *this ) );
+        threads_.back()->start( QThread::LowPriority );
+    }
+}
+
+//__________________________________________________________
+IconDecoder::~IconDecoder()
+{
+    {
+        QMutexLocker lock( &mutex_ );
+        abort_ = true;
+        requests_.clear();
+        condition_.wakeAll();
+    }
+
+    for( const auto& thread:threads_ )
+    { thread->wait(); }
+}
+
+//__________________________________________________________
+bool IconDecoder::isPending( const QString& key ) const
+{
+    QMutexLocker lock( &mutex_ );
+    return pending_.contains( key );
+}
+
+//__________________________________________________________
+void IconDecoder::setPixmapPath( const File::List& pixmapPath )
+{
+    QMutexLocker lock( &mutex_ );
+    if( pixmapPath_ == pixmapPath ) return;
+    pixmapPath_ = pixmapPath;
+    linkOverlays_.clear();
+    linkOverlaysLoaded_ = false;
+    PixmapPathIndex::get().setPathList( pixmapPath_ );
+}
+
+//__________________________________________________________
+bool IconDecoder::request( const Request& request )
+{
+    QMutexLocker lock( &mutex_ );
+    if( pending_.contains( request.key ) ) return false;
+    pending_.insert( request.key );
+    requests_.enqueue( request );
+    condition_.wakeOne();
+    return true;
+}
+
+//__________________________________________________________
+void IconDecoder::_process()
+{
+
+    forever
+    {
+
+        // get next request
+        Request request;
+        {
+            QMutexLocker lock( &mutex_ );
+            while( requests_.isEmpty() && !abort_ ) condition_.wait( &mutex_ );
+            if( abort_ ) return;
+            request = requests_.dequeue();
+        }
+
+        // decode and hand over to the decoder thread
+        const QString key( request.key );
+        const ImageList images( _decode( request ) );
+        QMetaObject::invokeMethod( this, [this, key, images]() { _deliver( key, images ); }, Qt::QueuedConnection );
+
+    }
+
+}
+
+//__________________________________________________________
+IconDecoder::ImageList IconDecoder::_decode( const Request& request )
+{
+
+    // load images from first matching icon name
+    ImageList images;
+    for( const auto& iconName:request.iconNames )
+    {
+        images = _load( iconName );
+        if( !images.isEmpty() ) break;
+    }
+
+    // compose overlays
+    for( auto& image:images )
+    {
+        if( request.type & BaseFileInfo::Link ) image = BaseFileIconProvider::linked( image, _linkOverlay( image.size() ) );
+        if( request.type & BaseFileInfo::Hidden ) image = BaseFileIconProvider::hidden( image );
+        if( request.type & BaseFileInfo::Clipped ) image = BaseFileIconProvider::clipped( image );
+    }
+
+    return images;
+
+}
+
+//__________________________________________________________
+IconDecoder::ImageList IconDecoder::_load( const QString& iconName ) const
+{
+
+    // copy pixmap path
+    File::List pixmapPath;
+    {
+        QMutexLocker lock( &mutex_ );
+        pixmapPath = pixmapPath_;
+    }
+
+    // same lookup as IconEngine, keeping one image per size
+    ImageList images;
+    for( const auto& path:pixmapPath )
+    {
+
+        // skip empty path
+        if( path.isEmpty() ) continue;
+
+        // see if path is internal resource path
+        File imageFile;
+        if( path.startsWith( ':' ) ) imageFile = File( iconName ).addPath( path );
+        else imageFile = PixmapPathIndex::get().find( path, File( iconName ) );
+        if( imageFile.isEmpty() ) continue;
+
+        // load image
+        QImage image( imageFile );
+        if( image.isNull() ) continue;
+
+        // check size
+        if( std::any_of( images.begin(), images.end(), [&image]( const QImage& current ) { return current.size() == image.size(); } ) ) continue;
+        images.append( image.convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+
+    }
+
+    return images;
+
+}
+
+//__________________________________________________________
+QImage IconDecoder::_linkOverlay( const QSize& size )
+{
+
+    // load overlays once
+    bool loaded;
+    {
+        QMutexLocker lock( &mutex_ );
+        loaded = linkOverlaysLoaded_;
+    }
+
+    if( !loaded )
+    {
+        const auto overlays( _load( IconNames::SymbolicLink ) );
+        QMutexLocker lock( &mutex_ );
+        linkOverlays_ = overlays;
+        linkOverlaysLoaded_ = true;
+    }
+
+    // pick smallest overlay larger than requested size, or largest
+    const QSize overlaySize( BaseFileIconProvider::linkOverlaySize( size ) );
+    QImage overlay;
+    {
+        QMutexLocker lock( &mutex_ );
+        for( const auto& image:linkOverlays_ )
+        {
+            if( overlay.isNull() ||
+                ( overlay.width() < overlaySize.width() && image.width() > overlay.width() ) ||
+                ( image.width() >= overlaySize.width() && image.width() < overlay.width() ) )
+            { overlay = image; }
+        }
+    }
+
+    if( overlay.isNull() || overlay.size() == overlaySize ) return overlay;
+    else return overlay.scaled( overlaySize, Qt::KeepAspectRatio, Qt::SmoothTransformation );
+
+}
+
+//__________________________________________________________
+void IconDecoder::_deliver( const QString& key, const ImageList& images )
+{
+    {
+        QMutexLocker lock( &mutex_ );
+        pending_.remove( key );
+    }
+
+    emit imagesAvailable( key, images );
+}
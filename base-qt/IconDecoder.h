@@ -0,0 +1,168 @@
+#ifndef IconDecoder_h
+#define IconDecoder_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "File.h"
+#include "base_qt_export.h"
+
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <memory>
+#include <vector>
+
+//* decode and compose icon images in worker threads
+class BASE_QT_EXPORT IconDecoder: public QObject, private Base::Counter<IconDecoder>
+{
+
+    Q_OBJECT
+
+    public:
+
+    //* constructor
+    explicit IconDecoder( QObject* = nullptr, int threadCount = 2 );
+
+    //* destructor
+    ~IconDecoder() override;
+
+    //* image list
+    using ImageList = QList<QImage>;
+
+    //* request
+    class BASE_QT_EXPORT Request
+    {
+
+        public:
+
+        //* key, used to deduplicate in-flight requests
+        QString key;
+
+        //* icon names, tried in order until one is found
+        QStringList iconNames;
+
+        //* file type, used for overlays
+        int type = 0;
+
+    };
+
+    //*@name accessors
+    //@{
+
+    //* true if a request with given key is in flight
+    bool isPending( const QString& ) const;
+
+    //@}
+
+    //*@name modifiers
+    //@{
+
+    //* pixmap path
+    void setPixmapPath( const File::List& );
+
+    //* add request. Returns false if a request with the same key is already in flight
+    bool request( const Request& );
+
+    //@}
+
+    Q_SIGNALS:
+
+    //* emitted when images matching a given key are available
+    void imagesAvailable( const QString&, const IconDecoder::ImageList& );
+
+    private:
+
+    //* worker thread
+    class Thread: public QThread
+    {
+
+        public:
+
+        //* constructor
+        explicit Thread( IconDecoder& decoder ):
+            decoder_( decoder )
+        {}
+
+        protected:
+
+        //* process requests
+        void run() override
+        { decoder_._process(); }
+
+        private:
+
+        //* parent decoder
+        IconDecoder& decoder_;
+
+    };
+
+    //* process requests until aborted. Called from worker threads
+    void _process();
+
+    //* decode and compose images for a given request
+    ImageList _decode( const Request& );
+
+    //* load all images matching a given icon name from pixmap path
+    ImageList _load( const QString& ) const;
+
+    //* link overlay, with size matching a given image size
+    QImage _linkOverlay( const QSize& );
+
+    //* deliver images. Called in the thread the decoder lives in
+    void _deliver( const QString&, const ImageList& );
+
+    //* mutex
+    mutable QMutex mutex_;
+
+    //* wait condition
+    QWaitCondition condition_;
+
+    //* pending requests
+    QQueue<Request> requests_;
+
+    //* keys of in-flight requests
+    QSet<QString> pending_;
+
+    //* pixmap path
+    File::List pixmapPath_;
+
+    //* link overlay images
+    ImageList linkOverlays_;
+
+    //* true when link overlay images are loaded
+    bool linkOverlaysLoaded_ = false;
+
+    //* abort flag
+    bool abort_ = false;
+
+    //* worker threads
+    std::vector<std::unique_ptr<Thread>> threads_;
+
+};
+
+#endif
@@ -18,6 +18,8 @@
 *******************************************************************************/
 
 #include "IconEngine.h"
+#include "PixmapPathIndex.h"
+#include "StartupProfiler.h"
 #include "XmlOptions.h"
 
 #include <QFileInfo>
@@ -32,7 +34,9 @@ IconEngine& IconEngine::get()
 
 //__________________________________________________________
 IconEngine::IconEngine():
-    Counter( QStringLiteral("IconEngine") )
+    Counter( QStringLiteral("IconEngine") ),
+    cache_( 64*1024*1024 ),
+    diskCache_( new ImageDiskCache( QStringLiteral("icons"), 32*1024*1024 ) )
 { Debug::Throw( QStringLiteral("IconEngine::IconEngine.\n") ); }
 
 //__________________________________________________________
@@ -45,10 +49,8 @@ bool IconEngine::reload()
     if( pathList == pixmapPath_ ) return false;
 
     pixmapPath_ = pathList;
-
-    for( auto&& iter = cache_.begin(); iter != cache_.end(); ++iter )
-    { cache_[iter.key()] = _get( iter.key(), iter.value().flags()&~static_cast<Base::IconCacheItem::Flags>(Base::IconCacheItem::Flag::FromCache) ); }
-
+    PixmapPathIndex::get().setPathList( pixmapPath_ );
+    cache_.setStale();
     return true;
 }
 
@@ -60,18 +62,19 @@ void IconEngine::clear()
 }
 
 //__________________________________________________________
-const Base::IconCacheItem& IconEngine::_get( const QString& file, Base::IconCacheItem::Flags flags )
+Base::IconCacheItem IconEngine::_get( const QString& file, Base::IconCacheItem::Flags flags )
 {
 
     // try find file in cache
     if( flags & Base::IconCacheItem::Flag::FromCache )
     {
-        Base::IconCache::iterator iter( cache_.find( file ) );
-        if( iter != cache_.end() ) return iter.value();
+        const auto item( cache_.find( file ) );
+        if( item ) return *item;
     }
 
     // debug
     Debug::Throw() << "IconEngine::_get - file: " << file << Qt::endl;
+    StartupProfiler::Scope scope( "IconEngine::_get" );
 
     // insert null icon for empty filename
     Base::IconCacheItem out;
@@ -98,7 +101,11 @@ const Base::IconCacheItem& IconEngine::_get( const QString& file, Base::IconCach
         } else {
 
             // make sure pixmap path is initialized
-            if( pixmapPath_.empty() ) pixmapPath_ = XmlOptions::get().specialOptions<File>( QStringLiteral("PIXMAP_PATH") );
+            if( pixmapPath_.empty() )
+            {
+                pixmapPath_ = XmlOptions::get().specialOptions<File>( QStringLiteral("PIXMAP_PATH") );
+                PixmapPathIndex::get().setPathList( pixmapPath_ );
+            }
 
             // store list of loaded sizes
             QList<QSize> sizes;
@@ -113,12 +120,12 @@ const Base::IconCacheItem& IconEngine::_get( const QString& file, Base::IconCach
 
                 // see if path is internal resource path
                 if( path.startsWith( ':' ) ) pixmapFile = File( file ).addPath( path );
-                else pixmapFile = File( path ).find( File( file ) );
+                else pixmapFile = PixmapPathIndex::get().find( path, File( file ) );
 
                 // load pixmap
                 if( pixmapFile.isEmpty() ) continue;
 
-                QPixmap pixmap( pixmapFile );
+                const QPixmap pixmap( _pixmap( pixmapFile ) );
                 if( pixmap.isNull() ) continue;
 
                 // check size
@@ -133,6 +140,23 @@ const Base::IconCacheItem& IconEngine::_get( const QString& file, Base::IconCach
 
     }
 
-    return cache_.insert( file, out ).value();
+    return cache_.insert( file, out, out.cost() );
+
+}
+
+//__________________________________________________________
+QPixmap IconEngine::_pixmap( const File& file )
+{
+
+    const ImageDiskCache::Key key( file );
+    auto image( diskCache_->find( key ) );
+    if( image.isNull() )
+    {
+        image = QImage( file );
+        if( image.isNull() ) return QPixmap();
+        diskCache_->insert( key, image );
+    }
+
+    return QPixmap::fromImage( image );
 
 }
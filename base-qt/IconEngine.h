@@ -24,9 +24,12 @@
 #include "Debug.h"
 #include "File.h"
 #include "IconCache.h"
+#include "ImageDiskCache.h"
 #include "NonCopyable.h"
 #include "base_qt_export.h"
 
+#include <memory>
+
 //* customized Icon factory to provide better looking disabled icons
 class BASE_QT_EXPORT IconEngine final: private Base::Counter<IconEngine>, private Base::NonCopyable<IconEngine>
 {
@@ -37,8 +40,8 @@ class BASE_QT_EXPORT IconEngine final: private Base::Counter<IconEngine>, privat
     static IconEngine& get();
 
     //* create icon
-    /*! the file is stored into a cache to avoid all pixmaps manipulations */
-    static const QIcon& get( const QString& file, Base::IconCacheItem::Flags flags = Base::IconCacheItem::Flag::Any )
+    /*! the file is stored into a cache to avoid all pixmaps manipulations. The icon is returned by value, since the cache can evict entries */
+    static QIcon get( const QString& file, Base::IconCacheItem::Flags flags = Base::IconCacheItem::Flag::Any )
     { return get()._get( file, flags ); }
 
     //* return cache
@@ -46,6 +49,7 @@ class BASE_QT_EXPORT IconEngine final: private Base::Counter<IconEngine>, privat
     { return get().cache_; }
 
     //* reload all icons set in cache from new path list
+    /** icons are marked stale, and loaded again when next requested */
     bool reload();
 
     //* clear
@@ -61,7 +65,10 @@ class BASE_QT_EXPORT IconEngine final: private Base::Counter<IconEngine>, privat
 
     //* create icon
     /*! the file is stored into a cache to avoid all pixmaps manipulations */
-    const Base::IconCacheItem& _get( const QString&, Base::IconCacheItem::Flags = Base::IconCacheItem::Flag::Any );
+    Base::IconCacheItem _get( const QString&, Base::IconCacheItem::Flags = Base::IconCacheItem::Flag::Any );
+
+    //* load pixmap from file, using disk cache
+    QPixmap _pixmap( const File& );
 
     //@}
 
@@ -71,6 +78,9 @@ class BASE_QT_EXPORT IconEngine final: private Base::Counter<IconEngine>, privat
     //* map files and QIcon
     Base::IconCache cache_;
 
+    //* decoded images, persistent across sessions
+    std::unique_ptr<ImageDiskCache> diskCache_;
+
 };
 
 #endif
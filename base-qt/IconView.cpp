@@ -41,6 +41,7 @@
 #include <QRegularExpression>
 #include <QStyle>
 
+#include <algorithm>
 #include <numeric>
 
 //____________________________________________________________________
@@ -205,6 +206,15 @@ bool IconView::setOptionName( const QString& value )
 
 }
 
+//____________________________________________________________________
+void IconView::setVirtualized( bool value )
+{
+    Debug::Throw() << "IconView::setVirtualized - value: " << value << Qt::endl;
+    if( virtualized_ == value ) return;
+    virtualized_ = value;
+    if( model_ ) doItemsLayout();
+}
+
 //____________________________________________________________________
 QModelIndex IconView::indexAt( const QPoint& constPosition ) const
 {
@@ -317,30 +327,39 @@ void IconView::doItemsLayout()
         else ++iter;
     }
 
+    // in virtualized mode, items are only loaded when shown
+    // measured sizes are kept, unless the estimate changed, for instance with icon size
+    loadedRows_.clear();
+    const QSize estimatedSize( virtualized_ ? _estimatedItemSize():QSize() );
+    const bool estimateChanged( estimatedSize != estimatedSize_ );
+    estimatedSize_ = estimatedSize;
+
     // update existing items and insert new ones
     for( int row = 0; row < rowCount; ++row )
     {
 
-        // index
-        const auto index( model_->index( row, 0 ) );
-
         // make sure row is in map
         const auto iter( items_.lowerBound( row ) );
         if( iter != items_.cend() && Base::areEquivalent( row, iter.key() ) )
         {
 
-            _updateItem( iter.value(), index );
+            auto& item( iter.value() );
+            if( !virtualized_ ) _loadItem( row, item );
+            else if( estimateChanged || !item.isMeasured() ) item.setEstimatedSize( estimatedSize );
+            else item.unload();
 
         } else {
 
             IconViewItem item;
-             _updateItem( item, index );
+            if( virtualized_ ) item.setEstimatedSize( estimatedSize );
+            else _loadItem( row, item );
             items_.insert( iter, row, item );
         }
 
     }
 
     _layoutItems();
+    _updateVisibleItems();
     updateGeometries();
     viewport()->update();
 
@@ -547,6 +566,36 @@ void IconView::scrollContentsBy( int dx, int dy )
 {
     dragOrigin_ += QPoint( dx, dy );
     QAbstractItemView::scrollContentsBy( dx, dy );
+    _updateVisibleItems();
+}
+
+//____________________________________________________________________
+void IconView::dataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles )
+{
+
+    QAbstractItemView::dataChanged( topLeft, bottomRight, roles );
+    if( !( model_ && topLeft.isValid() && bottomRight.isValid() ) ) return;
+
+    // update loaded items
+    bool sizeChanged( false );
+    for( auto&& iter = items_.find( topLeft.row() ); iter != items_.end() && iter.key() <= bottomRight.row(); ++iter )
+    {
+        auto& item( iter.value() );
+        if( !item.isLoaded() ) continue;
+
+        const QSize size( item.boundingRect().size() );
+        _loadItem( iter.key(), item );
+        if( item.boundingRect().size() != size ) sizeChanged = true;
+    }
+
+    if( sizeChanged )
+    {
+        _layoutItems();
+        updateGeometries();
+    }
+
+    viewport()->update();
+
 }
 
 //____________________________________________________________________
@@ -603,8 +652,9 @@ void IconView::paintEvent( QPaintEvent* event )
     painter.setFont( QApplication::font() );
     painter.setRenderHint( QPainter::TextAntialiasing, true );
 
-    // loop over events
-    for( auto&& iter = items_.constBegin(); iter != items_.constEnd(); ++iter )
+    // loop over items in clip rect rows
+    const auto rowRange( _rowRange( clipRect ) );
+    for( auto&& iter = items_.constFind( rowRange.first ); iter != items_.constEnd() && iter.key() <= rowRange.second; ++iter )
     {
         // check intersection with clipRect
         const auto& item( iter.value() );
@@ -632,6 +682,7 @@ void IconView::resizeEvent( QResizeEvent* event )
 
     QAbstractItemView::resizeEvent( event );
     _layoutItems();
+    _updateVisibleItems();
 
 }
 
@@ -968,6 +1019,14 @@ void IconView::_updateItem( IconViewItem& item, const QModelIndex& index ) const
 
 }
 
+//____________________________________________________________________
+void IconView::_loadItem( int row, IconViewItem& item )
+{
+    _updateItem( item, model_->index( row, 0 ) );
+    item.setLoaded( true );
+    if( virtualized_ ) loadedRows_.insert( row, ++loadStamp_ );
+}
+
 //____________________________________________________________________
 void IconView::_layoutItems()
 {
@@ -1051,6 +1110,7 @@ void IconView::_layoutItems()
     int row = 0;
     boundingRect_ = QRect();
     QPoint position( margin, margin_ );
+    rowPositions_.clear();
     for( auto&& iter = items_.begin(); iter != items_.end(); ++iter, ++column )
     {
 
@@ -1065,6 +1125,9 @@ void IconView::_layoutItems()
             rowHeight = 0;
         }
 
+        // store row position
+        if( column == 0 ) rowPositions_.append( position.y() );
+
         item.setPosition( position + QPoint( ( columnSizes[column] - item.boundingRect().width() )/2, 0 ) );
         item.setLocation( row, column );
         boundingRect_ |= item.boundingRect().translated( item.position() );
@@ -1074,6 +1137,73 @@ void IconView::_layoutItems()
 
 }
 
+//____________________________________________________________________
+void IconView::_updateVisibleItems()
+{
+
+    if( !( virtualized_ && model_ ) ) return;
+
+    // loading items can change the layout, which in turn can bring new items in the visible window.
+    // iterate, up to a fixed number of passes
+    QPair<int, int> rowRange;
+    bool sizeChanged( false );
+    for( int pass = 0; pass < 3; ++pass )
+    {
+
+        // visible window, including prefetch margin
+        const QRect rect( viewport()->rect().translated( _scrollBarPosition() ).adjusted( 0, -prefetchMargin_, 0, prefetchMargin_ ) );
+        rowRange = _rowRange( rect );
+
+        // load items
+        bool changed( false );
+        for( auto&& iter = items_.find( rowRange.first ); iter != items_.end() && iter.key() <= rowRange.second; ++iter )
+        {
+            auto& item( iter.value() );
+            if( item.isLoaded() ) loadedRows_.insert( iter.key(), ++loadStamp_ );
+            else {
+
+                const QSize size( item.boundingRect().size() );
+                _loadItem( iter.key(), item );
+                if( item.boundingRect().size() != size ) changed = true;
+
+            }
+        }
+
+        // measured sizes differ from estimate. Re-layout
+        if( !changed ) break;
+        _layoutItems();
+        sizeChanged = true;
+
+    }
+
+    // evict items outside of the window
+    _evictItems( rowRange.first, rowRange.second );
+
+    if( sizeChanged )
+    {
+        updateGeometries();
+        viewport()->update();
+    }
+
+}
+
+//____________________________________________________________________
+QPair<int, int> IconView::_rowRange( const QRect& rect ) const
+{
+
+    if( items_.empty() || rowPositions_.empty() ) return qMakePair( 0, -1 );
+
+    // layout rows
+    const int firstRow( std::upper_bound( rowPositions_.begin(), rowPositions_.end(), rect.top() ) - rowPositions_.begin() - 1 );
+    const int lastRow( std::upper_bound( rowPositions_.begin(), rowPositions_.end(), rect.bottom() ) - rowPositions_.begin() - 1 );
+    if( lastRow < 0 ) return qMakePair( 0, -1 );
+
+    // convert to item rows
+    const int columnCount( qMax( 1, columnCount_ ) );
+    return qMakePair( qMax( 0, firstRow )*columnCount, qMin( int(items_.size()), (lastRow+1)*columnCount ) - 1 );
+
+}
+
 //____________________________________________________________________
 QPixmap IconView::_pixmap( const QModelIndexList& indexes, QRect& boundingRect )
 {
@@ -1085,6 +1215,7 @@ QPixmap IconView::_pixmap( const QModelIndexList& indexes, QRect& boundingRect )
         // find item
         auto iter( items_.find( index.row() ) );
         if( iter == items_.end() ) continue;
+        if( !iter.value().isLoaded() ) _loadItem( iter.key(), iter.value() );
 
         // insert in map and update bounding rect
         Base::insert( items, iter.key(), iter.value() );
@@ -1593,3 +1724,40 @@ void IconView::_updateIconSizes( int iconSize )
     if( iter == iconSizes_.end() || *iter != iconSize )
     { iconSizes_.insert( iter, iconSize ); }
 }
+
+//___________________________________________________
+QSize IconView::_estimatedItemSize() const
+{
+    // icon, plus two lines of text
+    const QFontMetrics metrics( QApplication::font() );
+    const int width( qMax( IconViewItem::maxTextWidth, iconSize().width() ) );
+    const int height( iconSize().height() + IconViewItem::spacing + 2*metrics.lineSpacing() );
+    return QSize( width + 2*IconViewItem::margin, height + 2*IconViewItem::margin );
+}
+
+//___________________________________________________
+void IconView::_evictItems( int firstRow, int lastRow )
+{
+
+    if( loadedRows_.size() <= maxLoadedItems_ ) return;
+
+    // collect items outside of row range, least recently used first
+    QVector<QPair<quint64, int>> candidates;
+    for( auto&& iter = loadedRows_.constBegin(); iter != loadedRows_.constEnd(); ++iter )
+    {
+        if( iter.key() < firstRow || iter.key() > lastRow )
+        { candidates.append( qMakePair( iter.value(), iter.key() ) ); }
+    }
+
+    std::sort( candidates.begin(), candidates.end() );
+
+    // unload
+    for( const auto& candidate:candidates )
+    {
+        if( loadedRows_.size() <= maxLoadedItems_ ) break;
+        auto iter( items_.find( candidate.second ) );
+        if( iter != items_.end() ) iter.value().unload();
+        loadedRows_.remove( candidate.second );
+    }
+
+}
@@ -26,6 +26,7 @@
 #include "base_qt_export.h"
 
 #include <QBasicTimer>
+#include <QHash>
 #include <QString>
 #include <QTimerEvent>
 
@@ -91,6 +92,10 @@ class BASE_QT_EXPORT IconView: public QAbstractItemView, private Base::Counter<I
     //* minimum size hint
     QSize minimumSizeHint() const override;
 
+    //* true if items are loaded lazily
+    bool isVirtualized() const
+    { return virtualized_; }
+
     //@}
 
     //*@name modifiers
@@ -137,6 +142,21 @@ class BASE_QT_EXPORT IconView: public QAbstractItemView, private Base::Counter<I
     //* option name
     bool setOptionName( const QString& );
 
+    /**
+    \brief virtualized mode
+    items use a size estimate until first shown, and only items
+    within the viewport and prefetch margin are kept loaded
+    */
+    void setVirtualized( bool );
+
+    //* prefetch margin around viewport, in virtualized mode
+    void setPrefetchMargin( int value )
+    { prefetchMargin_ = value; }
+
+    //* maximum number of loaded items, in virtualized mode
+    void setMaxLoadedItems( int value )
+    { maxLoadedItems_ = value; }
+
     //* scroll to given index
     void scrollTo( const QModelIndex&, ScrollHint ) override;
 
@@ -250,6 +270,9 @@ class BASE_QT_EXPORT IconView: public QAbstractItemView, private Base::Counter<I
     //* contents scroll
     void scrollContentsBy( int, int ) override;
 
+    //* data changed
+    void dataChanged( const QModelIndex&, const QModelIndex&, const QVector<int>& = QVector<int>() ) override;
+
     //* horizontal offset
     int horizontalOffset() const override;
 
@@ -311,9 +334,18 @@ class BASE_QT_EXPORT IconView: public QAbstractItemView, private Base::Counter<I
     //* update item from index
     virtual void _updateItem( IconViewItem&, const QModelIndex& ) const;
 
+    //* load item text and pixmap from index
+    void _loadItem( int, IconViewItem& );
+
     //* layout existing items
     void _layoutItems();
 
+    //* load items in visible window and evict off-screen ones, in virtualized mode
+    void _updateVisibleItems();
+
+    //* range of rows intersecting a given rect, in contents coordinates
+    QPair<int, int> _rowRange( const QRect& ) const;
+
     //* scrollbar position
     QPoint _scrollBarPosition() const
     {
@@ -382,12 +414,44 @@ class BASE_QT_EXPORT IconView: public QAbstractItemView, private Base::Counter<I
     //* update internal icon sizes
     void _updateIconSizes( int );
 
+    //* size estimate for items not yet loaded
+    QSize _estimatedItemSize() const;
+
+    //* unload least recently used items outside of given row range
+    void _evictItems( int, int );
+
     //* headerView
     QHeaderView* header_ = nullptr;
 
     //* items
     IconViewItem::Map items_;
 
+    //* vertical position of each layout row
+    QVector<int> rowPositions_;
+
+    //*@name virtualization
+    //@{
+
+    //* true if items are loaded lazily
+    bool virtualized_ = false;
+
+    //* prefetch margin around viewport
+    int prefetchMargin_ = 256;
+
+    //* maximum number of loaded items
+    int maxLoadedItems_ = 512;
+
+    //* loaded rows, and last access stamp
+    QHash<int, quint64> loadedRows_;
+
+    //* access stamp
+    quint64 loadStamp_ = 0;
+
+    //* size estimate used at last layout
+    QSize estimatedSize_;
+
+    //@}
+
     //* find dialog
     BaseFindDialog* findDialog_ = nullptr;
 
@@ -66,6 +66,14 @@ class BASE_QT_EXPORT IconViewItem final: private Base::Counter<IconViewItem>
     //* bounding rect
     QRect boundingRect() const;
 
+    //* true if text and pixmap are loaded
+    bool isLoaded() const
+    { return loaded_; }
+
+    //* true if bounding rect was measured from loaded text and pixmap, rather than estimated
+    bool isMeasured() const
+    { return measured_; }
+
     //@}
 
     //*@name modifiers
@@ -98,6 +106,31 @@ class BASE_QT_EXPORT IconViewItem final: private Base::Counter<IconViewItem>
         column_ = column;
     }
 
+    //* set loaded state
+    void setLoaded( bool value )
+    {
+        loaded_ = value;
+        if( value ) measured_ = true;
+    }
+
+    //* use size estimate as bounding rect, until item is loaded
+    void setEstimatedSize( QSize size )
+    {
+        unload();
+        boundingRect_ = QRect( QPoint(), size );
+        dirty_ = false;
+        measured_ = false;
+    }
+
+    //* release text and pixmap, keeping last bounding rect
+    void unload()
+    {
+        if( dirty_ ) _updateBoundingRect();
+        pixmap_ = Pixmap();
+        text_.clear();
+        loaded_ = false;
+    }
+
     //@}
 
     //* item map
@@ -126,6 +159,12 @@ class BASE_QT_EXPORT IconViewItem final: private Base::Counter<IconViewItem>
     //* dirty
     bool dirty_ = true;
 
+    //* loaded
+    bool loaded_ = true;
+
+    //* measured
+    bool measured_ = false;
+
     //* pixmap
     Pixmap pixmap_;
 
@@ -0,0 +1,375 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "ImageDiskCache.h"
+#include "Debug.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QPalette>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace
+{
+
+    //* magic number
+    static const quint32 magic = 0x49444331;
+
+    //* format version. To be incremented on any format change
+    static const quint32 version = 1;
+
+    //* data stream version, fixed so that Qt5 and Qt6 builds share caches
+    static const int streamVersion = QDataStream::Qt_5_15;
+
+    //* write delay, in milliseconds
+    static const int writeDelay = 2000;
+
+    //* pixel data alignment
+    static const qint64 alignment = 16;
+
+    //* align offset
+    inline qint64 align( qint64 value )
+    { return ( value + alignment - 1 )/alignment*alignment; }
+
+}
+
+//________________________________________________________________
+ImageDiskCache::Key::Key( const QString& source, const QSize& size, uint palette, const QString& id ):
+    source( source ),
+    size( size ),
+    palette( palette ),
+    id( id )
+{
+    const QFileInfo info( source );
+    if( info.exists() && info.lastModified().isValid() ) modified = info.lastModified().toMSecsSinceEpoch();
+}
+
+//________________________________________________________________
+QByteArray ImageDiskCache::Key::toByteArray() const
+{
+    QByteArray out( source.toUtf8() );
+    out += '\n';
+    out += QByteArray::number( modified );
+    out += '\n';
+    out += QByteArray::number( size.width() ) + 'x' + QByteArray::number( size.height() );
+    out += '\n';
+    out += QByteArray::number( palette );
+    out += '\n';
+    out += id.toUtf8();
+    return out;
+}
+
+//________________________________________________________________
+ImageDiskCache::ImageDiskCache( const QString& name, qint64 maxSize, QObject* parent ):
+    QObject( parent ),
+    Counter( QStringLiteral("ImageDiskCache") ),
+    maxSize_( maxSize ),
+    entries_( maxSize )
+{
+
+    Debug::Throw() << "ImageDiskCache::ImageDiskCache - name: " << name << Qt::endl;
+
+    const QString path( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) );
+    if( !path.isEmpty() ) file_ = File( name + QStringLiteral(".cache") ).addPath( File( path ) );
+    thread_.reset( new Thread( file_ ) );
+
+    if( qApp ) connect( qApp, &QCoreApplication::aboutToQuit, this, &ImageDiskCache::write );
+    _read();
+
+}
+
+//________________________________________________________________
+ImageDiskCache::~ImageDiskCache()
+{ thread_->wait(); }
+
+//________________________________________________________________
+bool& ImageDiskCache::_enabled()
+{
+    static bool enabled = true;
+    return enabled;
+}
+
+//________________________________________________________________
+uint ImageDiskCache::hash( const QPalette& palette )
+{
+    uint out = 0;
+    for( int group = 0; group < QPalette::NColorGroups; ++group )
+    {
+        for( int role = 0; role < QPalette::NColorRoles; ++role )
+        { out = out*31 + palette.color( QPalette::ColorGroup( group ), QPalette::ColorRole( role ) ).rgba(); }
+    }
+
+    return out;
+}
+
+//________________________________________________________________
+QImage ImageDiskCache::find( const Key& key )
+{
+
+    if( !( isEnabled() && key.isValid() ) ) return QImage();
+
+    QMutexLocker lock( &mutex_ );
+    const auto image( entries_.find( key.toByteArray() ) );
+    return image ? *image:QImage();
+
+}
+
+//________________________________________________________________
+void ImageDiskCache::insert( const Key& key, const QImage& image )
+{
+
+    if( !( isEnabled() && key.isValid() ) || image.isNull() || file_.isEmpty() ) return;
+
+    const QImage converted( image.format() == QImage::Format_ARGB32_Premultiplied ? image:image.convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+    const QByteArray bytes( key.toByteArray() );
+    {
+        QMutexLocker lock( &mutex_ );
+
+        // identical images only change usage order, and need not be written
+        const auto existing( entries_.peek( bytes ) );
+        if( existing && *existing == converted )
+        {
+            entries_.find( bytes );
+            return;
+        }
+
+        entries_.insert( bytes, converted, converted.sizeInBytes() );
+        modified_ = true;
+    }
+
+    // restart timer, so that the cache is written once insertions stop. Timers can only be started from the object thread
+    if( QThread::currentThread() == thread() ) timer_.start( writeDelay, this );
+    else QMetaObject::invokeMethod( this, [this]() { timer_.start( writeDelay, this ); }, Qt::QueuedConnection );
+
+}
+
+//________________________________________________________________
+void ImageDiskCache::write()
+{
+
+    timer_.stop();
+    thread_->wait();
+
+    EntryList entries;
+    {
+        QMutexLocker lock( &mutex_ );
+        if( !modified_ ) return;
+        modified_ = false;
+        entries = _entries();
+        _unmap();
+    }
+
+    Debug::Throw() << "ImageDiskCache::write - file: " << file_ << " entries: " << entries.size() << Qt::endl;
+    thread_->setEntries( entries );
+    thread_->writeEntries();
+    thread_->setEntries( EntryList() );
+
+}
+
+//________________________________________________________________
+void ImageDiskCache::timerEvent( QTimerEvent* event )
+{
+
+    if( event->timerId() != timer_.timerId() ) return QObject::timerEvent( event );
+    timer_.stop();
+
+    // try again later if a write is in progress
+    if( thread_->isRunning() )
+    {
+        timer_.start( writeDelay, this );
+        return;
+    }
+
+    EntryList entries;
+    {
+        QMutexLocker lock( &mutex_ );
+        if( !modified_ ) return;
+        modified_ = false;
+        entries = _entries();
+        _unmap();
+    }
+
+    thread_->setEntries( entries );
+    thread_->start( QThread::LowPriority );
+
+}
+
+//________________________________________________________________
+void ImageDiskCache::_read()
+{
+
+    if( !isEnabled() || file_.isEmpty() ) return;
+
+    mapped_.reset( new QFile( file_ ) );
+    if( !mapped_->open( QIODevice::ReadOnly ) ) return;
+
+    const qint64 size( mapped_->size() );
+    uchar* data( size > 0 ? mapped_->map( 0, size ):nullptr );
+    if( !data ) return;
+
+    // index
+    const QByteArray buffer( QByteArray::fromRawData( reinterpret_cast<const char*>( data ), int( size ) ) );
+    QDataStream stream( buffer );
+    stream.setVersion( streamVersion );
+
+    quint32 fileMagic = 0;
+    quint32 fileVersion = 0;
+    quint32 count = 0;
+    stream >> fileMagic >> fileVersion >> count;
+    if( stream.status() != QDataStream::Ok || fileMagic != magic || fileVersion != version ) return;
+
+    class IndexEntry
+    {
+        public:
+        QByteArray key;
+        qint32 width = 0;
+        qint32 height = 0;
+        qint64 offset = 0;
+    };
+
+    QList<IndexEntry> index;
+    for( quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i )
+    {
+        IndexEntry entry;
+        stream >> entry.key >> entry.width >> entry.height >> entry.offset;
+        index.append( entry );
+    }
+
+    if( stream.status() != QDataStream::Ok ) return;
+
+    // images point to mapped data
+    // entries are stored most recently used first, and inserted in reverse order to restore usage order
+    mappedData_ = data;
+    mappedSize_ = size;
+    const qint64 dataStart( align( stream.device()->pos() ) );
+    for( auto&& iter = index.rbegin(); iter != index.rend(); ++iter )
+    {
+
+        const auto& entry( *iter );
+        if( entry.width <= 0 || entry.height <= 0 || entry.offset < 0 ) continue;
+        const qint64 bytes( qint64( entry.width )*entry.height*4 );
+        if( dataStart + entry.offset + bytes > size ) continue;
+
+        entries_.insert( entry.key, QImage( data + dataStart + entry.offset, entry.width, entry.height, entry.width*4, QImage::Format_ARGB32_Premultiplied ), bytes );
+
+    }
+
+    Debug::Throw() << "ImageDiskCache::_read - file: " << file_ << " entries: " << entries_.size() << Qt::endl;
+
+}
+
+//________________________________________________________________
+ImageDiskCache::EntryList ImageDiskCache::_entries() const
+{
+
+    // most recently used entries come first
+    EntryList out;
+    for( const auto& key:entries_.keys() )
+    { out.append( qMakePair( key, *entries_.peek( key ) ) ); }
+
+    // truncate to maximum size
+    qint64 total = 0;
+    for( int i = 0; i < out.size(); ++i )
+    {
+        total += out[i].second.sizeInBytes();
+        if( total > maxSize_ )
+        {
+            out = out.mid( 0, i );
+            break;
+        }
+    }
+
+    return out;
+
+}
+
+//________________________________________________________________
+void ImageDiskCache::_unmap()
+{
+
+    // on unix, the file can be replaced while mapped, and the mapping stays valid
+    #if defined(Q_OS_WIN)
+    if( !mappedData_ ) return;
+
+    // copy mapped images. Entries are inserted again least recently used first, to keep usage order
+    const auto keys( entries_.keys() );
+    for( auto&& iter = keys.rbegin(); iter != keys.rend(); ++iter )
+    {
+        QImage image( *entries_.peek( *iter ) );
+        if( image.constBits() >= mappedData_ && image.constBits() < mappedData_ + mappedSize_ ) image = image.copy();
+        entries_.insert( *iter, image, image.sizeInBytes() );
+    }
+
+    mapped_->unmap( mappedData_ );
+    mapped_.reset();
+    mappedData_ = nullptr;
+    mappedSize_ = 0;
+    #endif
+
+}
+
+//________________________________________________________________
+void ImageDiskCache::Thread::writeEntries()
+{
+
+    if( file_.isEmpty() ) return;
+    QDir().mkpath( QFileInfo( file_ ).absolutePath() );
+
+    // index, with offsets relative to pixel data
+    QByteArray index;
+    {
+        QDataStream stream( &index, QIODevice::WriteOnly );
+        stream.setVersion( streamVersion );
+        stream << magic << version << quint32( entries_.size() );
+
+        qint64 offset = 0;
+        for( const auto& entry:entries_ )
+        {
+            const auto& image( entry.second );
+            stream << entry.first << qint32( image.width() ) << qint32( image.height() ) << offset;
+            offset += align( qint64( image.width() )*image.height()*4 );
+        }
+    }
+
+    QSaveFile out( file_ );
+    if( !out.open( QIODevice::WriteOnly ) ) return;
+    out.write( index );
+    out.write( QByteArray( int( align( index.size() ) - index.size() ), 0 ) );
+
+    // pixel data, one line at a time to skip line padding
+    for( const auto& entry:entries_ )
+    {
+        const auto& image( entry.second );
+        const qint64 lineSize( qint64( image.width() )*4 );
+        for( int line = 0; line < image.height(); ++line )
+        { out.write( reinterpret_cast<const char*>( image.constScanLine( line ) ), lineSize ); }
+
+        const qint64 bytes( lineSize*image.height() );
+        out.write( QByteArray( int( align( bytes ) - bytes ), 0 ) );
+    }
+
+    if( !out.commit() )
+    { Debug::Throw(0) << "ImageDiskCache::Thread::writeEntries - unable to write " << file_ << Qt::endl; }
+
+}
@@ -0,0 +1,222 @@
+#ifndef ImageDiskCache_h
+#define ImageDiskCache_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "File.h"
+#include "LruCache.h"
+#include "base_qt_export.h"
+
+#include <QBasicTimer>
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QThread>
+#include <QTimerEvent>
+
+#include <memory>
+
+class QPalette;
+
+//* persistent image cache
+/**
+images are stored as premultiplied ARGB in a single file per cache, under the user cache directory.
+The file is memory mapped when the cache is created, so that cached images are not copied until used.
+Images kept in memory, mapped or inserted, are bounded by the cache maximum size, least recently used first.
+New images are written back in a separate thread, once no image was inserted for a short delay, and when the application quits.
+Images are keyed by source file, source modification time, size, palette hash and an optional element id
+*/
+class BASE_QT_EXPORT ImageDiskCache: public QObject, private Base::Counter<ImageDiskCache>
+{
+
+    Q_OBJECT
+
+    public:
+
+    //* constructor
+    explicit ImageDiskCache( const QString& name, qint64 maxSize, QObject* = nullptr );
+
+    //* destructor
+    ~ImageDiskCache() override;
+
+    //* key
+    class BASE_QT_EXPORT Key
+    {
+
+        public:
+
+        //* constructor. Modification time is read from source file
+        explicit Key( const QString& source, const QSize& size = QSize(), uint palette = 0, const QString& id = QString() );
+
+        //* true if valid
+        bool isValid() const
+        { return modified >= 0; }
+
+        //* serialized key
+        QByteArray toByteArray() const;
+
+        //* source file
+        QString source;
+
+        //* source file modification time, in milliseconds
+        qint64 modified = -1;
+
+        //* size
+        QSize size;
+
+        //* palette hash
+        uint palette = 0;
+
+        //* element id
+        QString id;
+
+    };
+
+    //*@name accessors
+    //@{
+
+    //* true if enabled
+    static bool isEnabled()
+    { return _enabled(); }
+
+    //* palette hash
+    static uint hash( const QPalette& );
+
+    //* cache file
+    const File& file() const
+    { return file_; }
+
+    //* find image matching key. Returns a null image if not found
+    /**
+    the returned image might refer to mapped data. On windows, where the file is unmapped before being replaced,
+    it must be converted or copied before the cache is next written
+    */
+    QImage find( const Key& );
+
+    //@}
+
+    //*@name modifiers
+    //@{
+
+    //* enable
+    static void setEnabled( bool value )
+    { _enabled() = value; }
+
+    //* insert image matching key
+    void insert( const Key&, const QImage& );
+
+    //* write pending changes, synchronously
+    void write();
+
+    //@}
+
+    protected:
+
+    //* timer event
+    void timerEvent( QTimerEvent* ) override;
+
+    private:
+
+    //* enabled flag
+    static bool& _enabled();
+
+    //* entry list, as written to file
+    using EntryList = QList<QPair<QByteArray, QImage>>;
+
+    //* map cache file and load index
+    void _read();
+
+    //* entries to be written, most recently used first, up to maximum size
+    EntryList _entries() const;
+
+    //* copy mapped images and unmap cache file, so that it can be replaced. Must be called with mutex locked
+    void _unmap();
+
+    //* write thread
+    class Thread: public QThread
+    {
+
+        public:
+
+        //* constructor
+        explicit Thread( const File& file ):
+            file_( file )
+        {}
+
+        //* entries
+        void setEntries( const EntryList& entries )
+        { entries_ = entries; }
+
+        //* write entries to file
+        void writeEntries();
+
+        protected:
+
+        //* write entries
+        void run() override
+        { writeEntries(); }
+
+        private:
+
+        //* file
+        File file_;
+
+        //* entries
+        EntryList entries_;
+
+    };
+
+    //* cache file
+    File file_;
+
+    //* maximum size, in bytes
+    qint64 maxSize_ = 0;
+
+    //* mapped cache file
+    std::unique_ptr<QFile> mapped_;
+
+    //* mapped data
+    uchar* mappedData_ = nullptr;
+
+    //* mapped data size
+    qint64 mappedSize_ = 0;
+
+    //* mutex
+    mutable QMutex mutex_;
+
+    //* images, indexed by serialized key
+    Base::LruCache<QByteArray, QImage> entries_;
+
+    //* true if entries were inserted since last write
+    bool modified_ = false;
+
+    //* write timer
+    QBasicTimer timer_;
+
+    //* write thread
+    std::unique_ptr<Thread> thread_;
+
+};
+
+#endif
@@ -408,6 +408,22 @@ class ListModel : public ItemModel
         selectedItems_.erase( std::remove_if( selectedItems_.begin(), selectedItems_.end(), [&copy]( const ValueType& current ) { return EqualTo()( copy, current ); }), selectedItems_.end() );
     }
 
+    //* remove value at given row, without update
+    void _removeRow( int row )
+    {
+        const auto copy( values_[row] );
+        values_.removeAt( row );
+        selectedItems_.erase( std::remove_if( selectedItems_.begin(), selectedItems_.end(), [&copy]( const ValueType& current ) { return EqualTo()( copy, current ); }), selectedItems_.end() );
+    }
+
+    //* remove all values matching predicate in a single pass, without update
+    template<typename Predicate>
+    void _removeIf( const Predicate& predicate )
+    {
+        values_.erase( std::remove_if( values_.begin(), values_.end(), predicate ), values_.end() );
+        selectedItems_.erase( std::remove_if( selectedItems_.begin(), selectedItems_.end(), predicate ), selectedItems_.end() );
+    }
+
     private:
 
     //* values
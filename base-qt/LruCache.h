@@ -0,0 +1,257 @@
+#ifndef LruCache_h
+#define LruCache_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "base_qt_export.h"
+
+#include <QHash>
+#include <QList>
+
+#include <list>
+
+namespace Base
+{
+
+    //* cache statistics
+    class BASE_QT_EXPORT CacheStatistics
+    {
+
+        public:
+
+        //* number of lookups that found a valid entry
+        qint64 hits = 0;
+
+        //* number of lookups that found no entry, or a stale one
+        qint64 misses = 0;
+
+        //* number of entries evicted to fit the cost budget
+        qint64 evictions = 0;
+
+    };
+
+    //* least recently used cache, bounded by the total cost of its entries
+    /**
+    the cost is typically the amount of memory used by an entry, in bytes.
+    The most recently inserted entry is always kept, even if its cost exceeds the budget.
+    Entries can be marked stale, in which case they are reported as missing until replaced.
+    References returned by find and insert are valid until the cache is next modified
+    */
+    template<class Key, class Value> class LruCache
+    {
+
+        public:
+
+        //* constructor
+        explicit LruCache( qint64 maxCost ):
+            maxCost_( maxCost )
+        {}
+
+        //* copy constructor
+        /** deleted, since items store positions in usage order */
+        LruCache( const LruCache& ) = delete;
+
+        //* assignment
+        LruCache& operator = ( const LruCache& ) = delete;
+
+        //*@name accessors
+        //@{
+
+        //* number of entries
+        int size() const
+        { return items_.size(); }
+
+        //* true if empty
+        bool isEmpty() const
+        { return items_.isEmpty(); }
+
+        //* true if an entry matches a given key, stale or not
+        bool contains( const Key& key ) const
+        { return items_.contains( key ); }
+
+        //* true if entry matching a given key is stale
+        bool isStale( const Key& key ) const
+        {
+            const auto iter( items_.constFind( key ) );
+            return iter != items_.constEnd() && iter.value().stale;
+        }
+
+        //* value matching a given key, without changing usage order and statistics
+        const Value* peek( const Key& key ) const
+        {
+            const auto iter( items_.constFind( key ) );
+            return iter == items_.constEnd() ? nullptr:&iter.value().value;
+        }
+
+        //* cost of entry matching a given key
+        qint64 cost( const Key& key ) const
+        { return items_.value( key ).cost; }
+
+        //* keys, most recently used first
+        QList<Key> keys() const
+        { return QList<Key>( order_.begin(), order_.end() ); }
+
+        //* maximum total cost
+        qint64 maxCost() const
+        { return maxCost_; }
+
+        //* total cost
+        qint64 totalCost() const
+        { return totalCost_; }
+
+        //* statistics
+        const CacheStatistics& statistics() const
+        { return statistics_; }
+
+        //@}
+
+        //*@name modifiers
+        //@{
+
+        //* find valid entry matching a given key and mark as most recently used
+        const Value* find( const Key& key )
+        {
+            const auto iter( items_.find( key ) );
+            if( iter == items_.end() || iter.value().stale )
+            {
+                ++statistics_.misses;
+                return nullptr;
+            }
+
+            ++statistics_.hits;
+            order_.splice( order_.begin(), order_, iter.value().position );
+            return &iter.value().value;
+        }
+
+        //* insert entry, replacing existing one if any, and evict least recently used entries as needed
+        const Value& insert( const Key& key, const Value& value, qint64 cost )
+        {
+            remove( key );
+            _evict( maxCost_ - cost );
+
+            order_.push_front( key );
+            totalCost_ += cost;
+            return items_.insert( key, Item( value, cost, order_.begin() ) ).value().value;
+        }
+
+        //* remove entry matching a given key
+        bool remove( const Key& key )
+        {
+            const auto iter( items_.find( key ) );
+            if( iter == items_.end() ) return false;
+            totalCost_ -= iter.value().cost;
+            order_.erase( iter.value().position );
+            items_.erase( iter );
+            return true;
+        }
+
+        //* clear
+        void clear()
+        {
+            items_.clear();
+            order_.clear();
+            totalCost_ = 0;
+        }
+
+        //* mark all entries as stale
+        void setStale()
+        {
+            for( auto&& item:items_ )
+            { item.stale = true; }
+        }
+
+        //* maximum total cost
+        void setMaxCost( qint64 value )
+        {
+            maxCost_ = value;
+            _evict( maxCost_ );
+        }
+
+        //* reset statistics
+        void resetStatistics()
+        { statistics_ = CacheStatistics(); }
+
+        //@}
+
+        private:
+
+        //* evict least recently used entries until total cost fits a given budget
+        void _evict( qint64 budget )
+        {
+            while( totalCost_ > budget && !order_.empty() )
+            {
+                const Key key( order_.back() );
+                remove( key );
+                ++statistics_.evictions;
+            }
+        }
+
+        //* keys, most recently used first
+        using KeyList = std::list<Key>;
+
+        //* cache item
+        class Item
+        {
+            public:
+
+            //* constructor
+            explicit Item() = default;
+
+            //* constructor
+            explicit Item( const Value& value, qint64 cost, typename KeyList::iterator position ):
+                value( value ),
+                cost( cost ),
+                position( position )
+            {}
+
+            //* value
+            Value value;
+
+            //* cost
+            qint64 cost = 0;
+
+            //* position in usage order
+            typename KeyList::iterator position;
+
+            //* true if stale
+            bool stale = false;
+
+        };
+
+        //* items
+        QHash<Key, Item> items_;
+
+        //* usage order
+        KeyList order_;
+
+        //* maximum total cost
+        qint64 maxCost_ = 0;
+
+        //* total cost
+        qint64 totalCost_ = 0;
+
+        //* statistics
+        CacheStatistics statistics_;
+
+    };
+
+}
+
+#endif
@@ -44,6 +44,10 @@ class BASE_QT_EXPORT MimeTypeIconProvider : public QObject, private Base::Counte
     //* icon matching given model index
     const QIcon& icon( const QString& );
 
+    //* icon name matching given extension
+    QString iconName( const QString& extension ) const
+    { return iconNames_.value( extension ); }
+
     //@}
 
     //*@name modifiers
@@ -0,0 +1,312 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "PixelKernels.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_KERNELS_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define PIXEL_KERNELS_HAVE_SSE2 0
+#endif
+
+namespace
+{
+
+    //* rounded division by 255, exact for x in [0, 255*255]
+    inline int div255( int x )
+    {
+        x += 0x80;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    //* channel
+    inline int channel( QRgb pixel, int index )
+    { return (pixel >> (8*index))&0xff; }
+
+    //* pixel from channels
+    inline QRgb pixel( int b, int g, int r, int a )
+    { return QRgb( b|(g << 8)|(r << 16)|(uint(a) << 24) ); }
+
+    #if PIXEL_KERNELS_HAVE_SSE2
+
+    //* rounded division by 255 of unsigned 16 bits lanes
+    inline __m128i div255( __m128i x )
+    {
+        x = _mm_add_epi16( x, _mm_set1_epi16( 0x80 ) );
+        return _mm_srli_epi16( _mm_add_epi16( x, _mm_srli_epi16( x, 8 ) ), 8 );
+    }
+
+    //* broadcast alpha of two pixels, unpacked to 16 bits lanes, to all their channels
+    inline __m128i alpha( __m128i x )
+    { return _mm_shufflehi_epi16( _mm_shufflelo_epi16( x, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) ); }
+
+    #endif
+
+    //* apply kernel to all pixels
+    /**
+    the vector kernel processes two pixels, unpacked to 16 bits lanes,
+    the scalar kernel processes a single pixel
+    */
+    template<class Vector, class Scalar>
+        void apply( QRgb* pixels, int count, const Vector& vector, const Scalar& scalar )
+    {
+        int index = 0;
+
+        #if PIXEL_KERNELS_HAVE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for( ; index + 4 <= count; index += 4 )
+        {
+            __m128i* address = reinterpret_cast<__m128i*>( pixels + index );
+            const __m128i value = _mm_loadu_si128( address );
+            const __m128i low = vector( _mm_unpacklo_epi8( value, zero ) );
+            const __m128i high = vector( _mm_unpackhi_epi8( value, zero ) );
+            _mm_storeu_si128( address, _mm_packus_epi16( low, high ) );
+        }
+        #else
+        Q_UNUSED( vector )
+        #endif
+
+        for( ; index < count; ++index )
+        { pixels[index] = scalar( pixels[index] ); }
+    }
+
+    //* apply kernel to all image scanlines
+    template<class Function>
+        void applyImage( QImage& image, const Function& function )
+    {
+        Base::PixelKernels::convert( image );
+        for( int row = 0; row < image.height(); ++row )
+        { function( reinterpret_cast<QRgb*>( image.scanLine( row ) ), image.width() ); }
+    }
+
+}
+
+namespace Base
+{
+
+    //_________________________________________________
+    void PixelKernels::desaturate( QRgb* pixels, int count )
+    {
+        #if PIXEL_KERNELS_HAVE_SSE2
+        // qGray weights, in memory order b, g, r, a
+        const __m128i weights = _mm_setr_epi16( 5, 16, 11, 0, 5, 16, 11, 0 );
+        const __m128i alphaMask = _mm_setr_epi16( 0, 0, 0, -1, 0, 0, 0, -1 );
+        auto vector = [&weights, &alphaMask]( __m128i x )
+        {
+            __m128i gray = _mm_madd_epi16( x, weights );
+            gray = _mm_srli_epi32( _mm_add_epi32( gray, _mm_srli_epi64( gray, 32 ) ), 5 );
+            gray = _mm_shufflehi_epi16( _mm_shufflelo_epi16( gray, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _MM_SHUFFLE( 0, 0, 0, 0 ) );
+            return _mm_or_si128( _mm_andnot_si128( alphaMask, gray ), _mm_and_si128( alphaMask, x ) );
+        };
+        #else
+        const int vector = 0;
+        #endif
+
+        apply( pixels, count, vector, []( QRgb value )
+        {
+            const int gray( qGray( value ) );
+            return qRgba( gray, gray, gray, qAlpha( value ) );
+        } );
+    }
+
+    //_________________________________________________
+    void PixelKernels::tint( QRgb* pixels, int count, QRgb color )
+    {
+        // premultiplied color
+        const int colorAlpha( qAlpha( color ) );
+        const int b( div255( qBlue( color )*colorAlpha ) );
+        const int g( div255( qGreen( color )*colorAlpha ) );
+        const int r( div255( qRed( color )*colorAlpha ) );
+
+        #if PIXEL_KERNELS_HAVE_SSE2
+        const __m128i premultiplied = _mm_setr_epi16( b, g, r, colorAlpha, b, g, r, colorAlpha );
+        auto vector = [&premultiplied]( __m128i x )
+        {
+            // screen, then mask with original alpha
+            const __m128i screen = _mm_sub_epi16( _mm_add_epi16( premultiplied, x ), div255( _mm_mullo_epi16( premultiplied, x ) ) );
+            return div255( _mm_mullo_epi16( screen, alpha( x ) ) );
+        };
+        #else
+        const int vector = 0;
+        #endif
+
+        const int source[4] = { b, g, r, colorAlpha };
+        apply( pixels, count, vector, [&source]( QRgb value )
+        {
+            const int a( qAlpha( value ) );
+            int out[4];
+            for( int index = 0; index < 4; ++index )
+            {
+                const int d( channel( value, index ) );
+                out[index] = div255( (source[index] + d - div255( source[index]*d ))*a );
+            }
+
+            return pixel( out[0], out[1], out[2], out[3] );
+        } );
+    }
+
+    //_________________________________________________
+    void PixelKernels::scaleAlpha( QRgb* pixels, int count, int alpha )
+    {
+        alpha = qBound( 0, alpha, 255 );
+        if( alpha == 255 ) return;
+
+        #if PIXEL_KERNELS_HAVE_SSE2
+        const __m128i factor = _mm_set1_epi16( alpha );
+        auto vector = [&factor]( __m128i x )
+        { return div255( _mm_mullo_epi16( x, factor ) ); };
+        #else
+        const int vector = 0;
+        #endif
+
+        apply( pixels, count, vector, [alpha]( QRgb value )
+        {
+            return pixel(
+                div255( channel( value, 0 )*alpha ),
+                div255( channel( value, 1 )*alpha ),
+                div255( channel( value, 2 )*alpha ),
+                div255( channel( value, 3 )*alpha ) );
+        } );
+    }
+
+    //_________________________________________________
+    void PixelKernels::highlight( QRgb* pixels, int count, int opacity )
+    {
+        opacity = qBound( 0, opacity, 255 );
+        if( opacity == 0 ) return;
+
+        // with full opacity, the pixel is entirely replaced by the mask
+        const int keep( opacity == 255 ? 0:1 );
+
+        #if PIXEL_KERNELS_HAVE_SSE2
+        const __m128i factor = _mm_set1_epi16( opacity );
+        const __m128i full = _mm_set1_epi16( 255 );
+        const __m128i keepMask = _mm_set1_epi16( keep ? -1:0 );
+        auto vector = [&factor, &full, &keepMask]( __m128i x )
+        {
+            const __m128i mask = div255( _mm_mullo_epi16( alpha( x ), factor ) );
+            const __m128i blend = _mm_and_si128( keepMask, div255( _mm_mullo_epi16( x, _mm_sub_epi16( full, mask ) ) ) );
+            return _mm_add_epi16( mask, blend );
+        };
+        #else
+        const int vector = 0;
+        #endif
+
+        apply( pixels, count, vector, [opacity, keep]( QRgb value )
+        {
+            const int mask( div255( qAlpha( value )*opacity ) );
+            int out[4];
+            for( int index = 0; index < 4; ++index )
+            { out[index] = mask + keep*div255( channel( value, index )*(255 - mask) ); }
+
+            return pixel( out[0], out[1], out[2], out[3] );
+        } );
+    }
+
+    //_________________________________________________
+    void PixelKernels::sourceOver( QRgb* destination, const QRgb* source, int count )
+    {
+        int index = 0;
+
+        #if PIXEL_KERNELS_HAVE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16( 255 );
+        for( ; index + 4 <= count; index += 4 )
+        {
+            __m128i* address = reinterpret_cast<__m128i*>( destination + index );
+            const __m128i d = _mm_loadu_si128( address );
+            const __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + index ) );
+
+            const __m128i sLow = _mm_unpacklo_epi8( s, zero );
+            const __m128i sHigh = _mm_unpackhi_epi8( s, zero );
+            const __m128i low = _mm_add_epi16( sLow, div255( _mm_mullo_epi16( _mm_unpacklo_epi8( d, zero ), _mm_sub_epi16( full, alpha( sLow ) ) ) ) );
+            const __m128i high = _mm_add_epi16( sHigh, div255( _mm_mullo_epi16( _mm_unpackhi_epi8( d, zero ), _mm_sub_epi16( full, alpha( sHigh ) ) ) ) );
+            _mm_storeu_si128( address, _mm_packus_epi16( low, high ) );
+        }
+        #endif
+
+        for( ; index < count; ++index )
+        {
+            const QRgb s( source[index] );
+            const QRgb d( destination[index] );
+            const int inverse( 255 - qAlpha( s ) );
+            if( inverse == 255 ) continue;
+            if( inverse == 0 )
+            {
+                destination[index] = s;
+                continue;
+            }
+
+            int out[4];
+            for( int channelIndex = 0; channelIndex < 4; ++channelIndex )
+            { out[channelIndex] = qMin( 255, channel( s, channelIndex ) + div255( channel( d, channelIndex )*inverse ) ); }
+
+            destination[index] = pixel( out[0], out[1], out[2], out[3] );
+        }
+    }
+
+    //_________________________________________________
+    void PixelKernels::convert( QImage& image )
+    {
+        if( image.format() != QImage::Format_ARGB32_Premultiplied )
+        { image = image.convertToFormat( QImage::Format_ARGB32_Premultiplied ); }
+    }
+
+    //_________________________________________________
+    void PixelKernels::desaturate( QImage& image )
+    { applyImage( image, []( QRgb* pixels, int count ) { desaturate( pixels, count ); } ); }
+
+    //_________________________________________________
+    void PixelKernels::tint( QImage& image, QRgb color )
+    { applyImage( image, [color]( QRgb* pixels, int count ) { tint( pixels, count, color ); } ); }
+
+    //_________________________________________________
+    void PixelKernels::scaleAlpha( QImage& image, int alpha )
+    { applyImage( image, [alpha]( QRgb* pixels, int count ) { scaleAlpha( pixels, count, alpha ); } ); }
+
+    //_________________________________________________
+    void PixelKernels::highlight( QImage& image, int opacity )
+    { applyImage( image, [opacity]( QRgb* pixels, int count ) { highlight( pixels, count, opacity ); } ); }
+
+    //_________________________________________________
+    void PixelKernels::sourceOver( QImage& image, const QImage& overlay, const QPoint& position )
+    {
+        if( image.isNull() || overlay.isNull() ) return;
+        convert( image );
+
+        QImage source( overlay );
+        convert( source );
+
+        // clip
+        const QRect rect( QRect( position, source.size() ).intersected( image.rect() ) );
+        if( rect.isEmpty() ) return;
+
+        for( int row = rect.top(); row <= rect.bottom(); ++row )
+        {
+            sourceOver(
+                reinterpret_cast<QRgb*>( image.scanLine( row ) ) + rect.left(),
+                reinterpret_cast<const QRgb*>( source.constScanLine( row - position.y() ) ) + rect.left() - position.x(),
+                rect.width() );
+        }
+    }
+
+}
@@ -0,0 +1,88 @@
+#ifndef PixelKernels_h
+#define PixelKernels_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "base_qt_export.h"
+
+#include <QImage>
+#include <QRgb>
+
+namespace Base
+{
+
+    //* pixel kernels operating in place on premultiplied ARGB32 scanlines
+    /**
+    SSE2 is used when available, four pixels at a time, with a scalar fallback for remaining pixels.
+    All kernels are reentrant and can be used from worker threads
+    */
+    class BASE_QT_EXPORT PixelKernels
+    {
+
+        public:
+
+        //*@name scanlines
+        //@{
+
+        //* replace colors by their gray level, as given by qGray, keeping alpha
+        static void desaturate( QRgb*, int count );
+
+        //* screen with a given color, and mask with the original alpha
+        static void tint( QRgb*, int count, QRgb color );
+
+        //* multiply all channels by alpha, in [0,255]
+        static void scaleAlpha( QRgb*, int count, int alpha );
+
+        //* blend white with a given opacity, in [0,255], masked by the pixel alpha. With opacity 255, result is the white mask itself
+        static void highlight( QRgb*, int count, int opacity );
+
+        //* composite source over destination
+        static void sourceOver( QRgb* destination, const QRgb* source, int count );
+
+        //@}
+
+        //*@name images
+        //@{
+
+        //* convert image to premultiplied ARGB32 if needed
+        static void convert( QImage& );
+
+        //* desaturate
+        static void desaturate( QImage& );
+
+        //* tint
+        static void tint( QImage&, QRgb color );
+
+        //* scale alpha
+        static void scaleAlpha( QImage&, int alpha );
+
+        //* highlight
+        static void highlight( QImage&, int opacity );
+
+        //* composite overlay over image at a given position, in device pixels. Overlay is clipped to the image
+        static void sourceOver( QImage&, const QImage& overlay, const QPoint& );
+
+        //@}
+
+    };
+
+}
+
+#endif
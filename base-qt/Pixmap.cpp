@@ -21,6 +21,9 @@
 #include "Debug.h"
 #include "File.h"
 #include "IconSize.h"
+#include "LruCache.h"
+#include "PixelKernels.h"
+#include "PixmapCache.h"
 #include "PixmapEngine.h"
 #include "QtUtil.h"
 
@@ -30,6 +33,89 @@
 #include <QPainter>
 #include <QFileIconProvider>
 
+namespace
+{
+
+    //* derived pixmap effect
+    enum class Effect
+    {
+        Transparent,
+        Desaturated,
+        Colorized,
+        Merged,
+        Highlighted
+    };
+
+    //* derived pixmap key
+    class EffectKey
+    {
+        public:
+
+        //* equal to operator
+        bool operator == ( const EffectKey& other ) const
+        {
+            return
+                source == other.source &&
+                effect == other.effect &&
+                parameter == other.parameter &&
+                overlay == other.overlay;
+        }
+
+        //* source cache key
+        qint64 source = 0;
+
+        //* effect
+        Effect effect = Effect::Transparent;
+
+        //* effect parameter
+        quint64 parameter = 0;
+
+        //* overlay cache key, for merged pixmaps
+        qint64 overlay = 0;
+
+    };
+
+    //* hash
+    inline uint qHash( const EffectKey& key )
+    { return ::qHash( key.source )^(uint( key.effect ) << 24)^::qHash( key.parameter )^::qHash( key.overlay ); }
+
+    //* derived pixmaps, shared by all pixmaps
+    /**
+    cache keys change whenever a pixmap is modified and are never reused,
+    so that entries never need to be invalidated explicitly.
+    Pixmaps are only manipulated in the main thread
+    */
+    using EffectCache = Base::LruCache<EffectKey, QPixmap>;
+    EffectCache& effectCache()
+    {
+        static EffectCache cache( 16*1024*1024 );
+        return cache;
+    }
+
+    //* find derived pixmap in cache or create it using a function that modifies the source image in place
+    template<class Function>
+        Pixmap memoized( const QPixmap& source, Effect effect, quint64 parameter, qint64 overlay, const Function& function )
+    {
+        EffectKey key;
+        key.source = source.cacheKey();
+        key.effect = effect;
+        key.parameter = parameter;
+        key.overlay = overlay;
+
+        auto& cache( effectCache() );
+        if( auto pixmap = cache.find( key ) ) return Pixmap( *pixmap );
+
+        QImage image( source.toImage() );
+        Base::PixelKernels::convert( image );
+        function( image );
+
+        const QPixmap pixmap( QPixmap::fromImage( image ) );
+        cache.insert( key, pixmap, Base::pixmapCost( pixmap ) );
+        return Pixmap( pixmap );
+    }
+
+}
+
 //_________________________________________________
 Pixmap::Pixmap( QSize size, Flags flags ):
     QPixmap( size*qApp->devicePixelRatio() ),
@@ -109,19 +195,9 @@ Pixmap Pixmap::transparent( qreal intensity ) const
 {
     if( isNull() ) return *this;
 
-    Pixmap out( *this );
-    QPainter painter( &out );
-
-    QColor color( Qt::black );
-    color.setAlphaF( intensity );
-
-    painter.setCompositionMode( QPainter::CompositionMode_DestinationIn );
-    painter.setPen( Qt::NoPen );
-    painter.setBrush( color );
-    painter.drawRect( out.rect() );
-    painter.end();
-
-    return out;
+    const int alpha( qBound( 0, qRound( 255*intensity ), 255 ) );
+    return memoized( *this, Effect::Transparent, alpha, 0, [alpha]( QImage& image )
+    { Base::PixelKernels::scaleAlpha( image, alpha ); } );
 }
 
 //_________________________________________________
@@ -129,83 +205,62 @@ Pixmap Pixmap::desaturated() const
 {
     if( isNull() ) return *this;
 
-    QImage image( toImage() );
-    if( image.format() != QImage::Format_ARGB32_Premultiplied )
-    {
-        Debug::Throw(0) << "Pixmap::desaturate - wrong format." << Qt::endl;
-        return *this;
-    }
-
-    for( int row = 0; row < image.height(); ++row )
-    {
-
-        // alter pixmaps
-        QRgb* pixels = reinterpret_cast<QRgb*>( image.scanLine( row ) );
-
-        for( int column = 0; column < image.width(); ++column )
-        {
-            const int gray( qGray( pixels[column] ) );
-            pixels[column] = qRgba( gray, gray, gray, qAlpha(pixels[column]) );
-        }
-    }
-
-    return Pixmap( image );
+    return memoized( *this, Effect::Desaturated, 0, 0, []( QImage& image )
+    { Base::PixelKernels::desaturate( image ); } );
 }
 
 //_________________________________________________
 Pixmap Pixmap::colorized( const QColor& color ) const
 {
+    if( isNull() ) return *this;
 
-    Pixmap out( desaturated() );
-    QPainter painter( &out );
-    painter.setCompositionMode(QPainter::CompositionMode_Screen);
-    painter.fillRect(rect(), color);
-
-    // copy alpha channel from source
-    painter.setCompositionMode( QPainter::CompositionMode_DestinationIn );
-    painter.drawPixmap( out.rect(), *this );
-
-    painter.end();
-    return out;
+    const QRgb rgba( color.rgba() );
+    return memoized( *this, Effect::Colorized, rgba, 0, [rgba]( QImage& image )
+    {
+        Base::PixelKernels::desaturate( image );
+        Base::PixelKernels::tint( image, rgba );
+    } );
 }
 
-
 //_________________________________________________
 Pixmap Pixmap::merged( const QPixmap& pixmap, Corner corner ) const
 {
     if( isNull() ) return *this;
 
-    QSize size( this->size()/devicePixelRatio() );
-    QSize pixmapSize( pixmap.size()/pixmap.devicePixelRatio() );
-    QImage source( toImage() );
-    QPainter painter( &source );
-    switch( corner )
+    const qreal ratio( devicePixelRatio() );
+    return memoized( *this, Effect::Merged, quint64( corner ) | (quint64( qRound( 100*ratio ) ) << 8), pixmap.cacheKey(), [&pixmap, corner, ratio]( QImage& image )
     {
 
-        case Corner::TopRight:
-        painter.drawPixmap( QPoint( size.width()-pixmapSize.width(), 0 ), pixmap );
-        break;
+        // overlay position, in logical coordinates
+        const QSize size( image.size()/ratio );
+        const QSize pixmapSize( pixmap.size()/pixmap.devicePixelRatio() );
+        QPoint position;
+        switch( corner )
+        {
+            case Corner::TopRight: position = QPoint( size.width()-pixmapSize.width(), 0 ); break;
+            case Corner::BottomLeft: position = QPoint( 0, size.height()-pixmapSize.height() ); break;
+            case Corner::BottomRight: position = QPoint( size.width()-pixmapSize.width(), size.height()-pixmapSize.height() ); break;
+            case Corner::Center: position = QPoint( (size.width()-pixmapSize.width())/2, (size.height()-pixmapSize.height())/2 ); break;
+            case Corner::TopLeft: default: break;
+        }
+
+        if( pixmap.devicePixelRatio() == ratio )
+        {
 
-        case Corner::BottomLeft:
-        painter.drawPixmap( QPoint( 0, size.height()-pixmapSize.height() ), pixmap );
-        break;
+            // same resolution, composite pixels directly
+            Base::PixelKernels::sourceOver( image, pixmap.toImage(), position*ratio );
 
-        case Corner::BottomRight:
-        painter.drawPixmap( QPoint( size.width()-pixmapSize.width(), size.height()-pixmapSize.height() ), pixmap );
-        break;
+        } else {
 
-        case Corner::Center:
-        painter.drawPixmap(  QPoint( (size.width()-pixmapSize.width())/2, (size.height()-pixmapSize.height())/2 ), pixmap );
-        break;
+            // overlay needs scaling
+            QPainter painter( &image );
+            painter.drawPixmap( position, pixmap );
+            painter.end();
 
-        case Corner::TopLeft:
-        painter.drawPixmap( QPoint( 0, 0 ), pixmap );
-        break;
+        }
 
-    }
+    } );
 
-    painter.end();
-    return Pixmap( fromImage( source ) );
 }
 
 //_________________________________________________
@@ -213,36 +268,10 @@ Pixmap Pixmap::highlighted( qreal opacity ) const
 {
 
     Debug::Throw( QStringLiteral("Pixmap::highlighted.\n") );
-    if( opacity <= 0 ) return *this;
-    opacity = qMin<qreal>( opacity, 1.0 );
-
-    // compute mask
-    Pixmap mask( *this );
-    {
-        QPainter painter( &mask );
-
-        painter.setRenderHints(QPainter::SmoothPixmapTransform);
-        painter.setPen( Qt::NoPen );
+    if( opacity <= 0 || isNull() ) return *this;
 
-        QColor color( Qt::white );
-        color.setAlphaF( opacity );
-        painter.setBrush( color );
+    const int alpha( qBound( 0, qRound( 255*opacity ), 255 ) );
+    return memoized( *this, Effect::Highlighted, alpha, 0, [alpha]( QImage& image )
+    { Base::PixelKernels::highlight( image, alpha ); } );
 
-        painter.setCompositionMode( QPainter::CompositionMode_SourceIn );
-
-        painter.drawRect( mask.rect() );
-        painter.end();
-    }
-
-    if( opacity == 1.0 ) return mask;
-
-    // apply highlight
-    Pixmap out( *this );
-    {
-        QPainter painter( &out );
-        painter.drawPixmap( QPoint(0,0), mask );
-        painter.end();
-    }
-
-    return out;
 }
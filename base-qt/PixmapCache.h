@@ -20,12 +20,17 @@
 *
 *******************************************************************************/
 
-#include <QHash>
+#include "LruCache.h"
+
 #include <QPixmap>
 
 //! cache
 namespace Base
 {
-    using PixmapCache = QHash<QString, QPixmap>;
+    using PixmapCache = LruCache<QString, QPixmap>;
+
+    //! approximate memory used by a pixmap, in bytes
+    inline qint64 pixmapCost( const QPixmap& pixmap )
+    { return qint64( pixmap.width() )*pixmap.height()*pixmap.depth()/8; }
 }
 #endif
@@ -19,6 +19,8 @@
 
 #include "PixmapEngine.h"
 #include "File.h"
+#include "PixmapPathIndex.h"
+#include "StartupProfiler.h"
 #include "XmlOptions.h"
 
 #include <QFileInfo>
@@ -33,7 +35,8 @@ PixmapEngine& PixmapEngine::get()
 
 //__________________________________________________________
 PixmapEngine::PixmapEngine():
-    Counter( QStringLiteral("PixmapEngine") )
+    Counter( QStringLiteral("PixmapEngine") ),
+    cache_( 32*1024*1024 )
 { Debug::Throw( QStringLiteral("PixmapEngine::PixmapEngine.\n") ); }
 
 //__________________________________________________________
@@ -46,30 +49,36 @@ bool PixmapEngine::reload()
     if( pathList == pixmapPath_ ) return false;
 
     pixmapPath_ = pathList;
-    for( auto&& iter = cache_.begin(); iter != cache_.end(); ++iter )
-    { cache_[iter.key()] = _get( iter.key(), false ); }
-
+    PixmapPathIndex::get().setPathList( pixmapPath_ );
+    cache_.setStale();
     return true;
 }
 
 //__________________________________________________________
-const QPixmap& PixmapEngine::_get( const QString& file, bool fromCache )
+QPixmap PixmapEngine::_get( const QString& file, bool fromCache )
 {
     Debug::Throw( QStringLiteral("PixmapEngine::_get (file).\n") );
 
     // try find file in cache
     if( fromCache )
     {
-        Base::PixmapCache::iterator iter( cache_.find( file ) );
-        if( iter != cache_.end() ) return iter.value();
+        const auto pixmap( cache_.find( file ) );
+        if( pixmap ) return *pixmap;
     }
 
+    StartupProfiler::Scope scope( "PixmapEngine::_get" );
+
     // create output
     QPixmap out;
     if( QFileInfo( file ).isAbsolute() ) { out = QPixmap( file ); }
     else {
 
-        if( pixmapPath_.empty() ) pixmapPath_ = XmlOptions::get().specialOptions<File>( QStringLiteral("PIXMAP_PATH") );
+        if( pixmapPath_.empty() )
+        {
+            pixmapPath_ = XmlOptions::get().specialOptions<File>( QStringLiteral("PIXMAP_PATH") );
+            PixmapPathIndex::get().setPathList( pixmapPath_ );
+        }
+
         for( const auto& path:pixmapPath_ )
         {
 
@@ -81,7 +90,7 @@ const QPixmap& PixmapEngine::_get( const QString& file, bool fromCache )
 
             // see if path is internal resource path
             if( path.startsWith( ':' ) ) pixmapFile = File( file ).addPath( path );
-            else pixmapFile = File( path ).find( File( file ) );
+            else pixmapFile = PixmapPathIndex::get().find( path, File( file ) );
 
             // load pixmap
             if( !pixmapFile.isEmpty() )
@@ -94,6 +103,6 @@ const QPixmap& PixmapEngine::_get( const QString& file, bool fromCache )
 
     }
 
-    return cache_.insert( file, out ).value();
+    return cache_.insert( file, out, Base::pixmapCost( out ) );
 
 }
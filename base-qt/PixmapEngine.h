@@ -36,8 +36,8 @@ class BASE_QT_EXPORT PixmapEngine final: private Base::Counter<PixmapEngine>, pr
     static PixmapEngine& get();
 
     //* create icon
-    /*! the file is stored into a cache to avoid all pixmaps manipulations */
-    static const QPixmap& get( const QString& file, bool fromCache = true )
+    /*! the file is stored into a cache to avoid all pixmaps manipulations. The pixmap is returned by value, since the cache can evict entries */
+    static QPixmap get( const QString& file, bool fromCache = true )
     { return get()._get( file, fromCache ); }
 
     //* return cache
@@ -45,6 +45,7 @@ class BASE_QT_EXPORT PixmapEngine final: private Base::Counter<PixmapEngine>, pr
     { return get().cache_; }
 
     //* reload all icons set in cache from new path list
+    /** pixmaps are marked stale, and loaded again when next requested */
     bool reload();
 
     private:
@@ -57,7 +58,7 @@ class BASE_QT_EXPORT PixmapEngine final: private Base::Counter<PixmapEngine>, pr
 
     //* create icon
     /*! the file is stored into a cache to avoid all pixmaps manipulations */
-    const QPixmap& _get( const QString& file, bool fromCache );
+    QPixmap _get( const QString& file, bool fromCache );
 
     //@}
 
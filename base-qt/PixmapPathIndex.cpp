@@ -0,0 +1,249 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "PixmapPathIndex.h"
+#include "Debug.h"
+
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutexLocker>
+
+namespace
+{
+    //* maximum time spent waiting for a directory to be indexed, in find (ms)
+    static const int maxWait = 2000;
+}
+
+//__________________________________________________________
+PixmapPathIndex& PixmapPathIndex::get()
+{
+    //* singleton
+    static PixmapPathIndex singleton_;
+    return singleton_;
+}
+
+//__________________________________________________________
+PixmapPathIndex::PixmapPathIndex():
+    Counter( QStringLiteral("PixmapPathIndex") ),
+    thread_( new Thread( *this ) )
+{
+    Debug::Throw( QStringLiteral("PixmapPathIndex::PixmapPathIndex.\n") );
+    for( const auto& format:QImageReader::supportedImageFormats() )
+    { suffixes_.insert( QString::fromLatin1( format ).toLower() ); }
+    suffixes_.insert( QStringLiteral("svg") );
+    suffixes_.insert( QStringLiteral("svgz") );
+}
+
+//__________________________________________________________
+PixmapPathIndex::~PixmapPathIndex()
+{
+    {
+        QMutexLocker lock( &mutex_ );
+        abort_ = true;
+        pending_.clear();
+        condition_.wakeAll();
+    }
+
+    thread_->wait();
+}
+
+//__________________________________________________________
+bool PixmapPathIndex::isReady() const
+{
+    QMutexLocker lock( &mutex_ );
+    return pending_.isEmpty();
+}
+
+//__________________________________________________________
+bool PixmapPathIndex::setPathList( const File::List& pathList )
+{
+
+    {
+        QMutexLocker lock( &mutex_ );
+        if( pathList == pathList_ ) return false;
+        Debug::Throw( QStringLiteral("PixmapPathIndex::setPathList.\n") );
+
+        // directories are all rebuilt, to account for files added in the meantime
+        pathList_ = pathList;
+        pending_.clear();
+        directories_.clear();
+        ++generation_;
+
+        // resource and empty paths are not indexed
+        for( const auto& path:pathList_ )
+        { if( !( path.isEmpty() || path.startsWith( ':' ) ) ) pending_.append( path ); }
+
+        condition_.wakeAll();
+    }
+
+    if( !thread_->isRunning() ) thread_->start( QThread::LowPriority );
+    return true;
+
+}
+
+//__________________________________________________________
+File PixmapPathIndex::find( const File& path, const File& file )
+{
+
+    // only image files are indexed
+    const QString name( QFileInfo( file ).fileName() );
+    if( name.isEmpty() || file.isAbsolute() || !_isImage( name ) ) return path.find( file );
+
+    // get matching directory
+    DirectoryPtr directory;
+    {
+        QMutexLocker lock( &mutex_ );
+        directory = directories_.value( path );
+
+        // directories not indexed yet are moved first in the queue, and waited for, with a bound,
+        // rather than searched directly while the worker thread walks the same tree
+        if( !directory && pending_.contains( path ) )
+        {
+
+            pending_.removeOne( path );
+            pending_.prepend( path );
+            condition_.wakeAll();
+
+            const QDeadlineTimer deadline( maxWait );
+            while( !( directory || abort_ ) && pending_.contains( path ) && condition_.wait( &mutex_, deadline ) )
+            { directory = directories_.value( path ); }
+
+            if( !directory ) Debug::Throw(0) << "PixmapPathIndex::find - not indexed in time: " << path << Qt::endl;
+
+        }
+    }
+
+    // directories that are not in the path list, or not indexed in time, are searched directly
+    if( !directory ) return path.find( file );
+
+    // relative directory, for file names containing a path
+    const QString relativePath( file.get().size() > name.size() ? file.get().left( file.get().size() - name.size() - 1 ):QString() );
+
+    // find matching candidate whose parent directory comes first in lookup order
+    QString match;
+    int matchRank = -1;
+    for( const auto& candidate:directory->files.value( name ) )
+    {
+
+        // candidate is the directory containing a file with matching name
+        QString parent( candidate );
+        if( !relativePath.isEmpty() )
+        {
+            if( !( parent.endsWith( relativePath ) && parent.size() > relativePath.size() && parent.at( parent.size() - relativePath.size() - 1 ) == QLatin1Char( '/' ) ) ) continue;
+            parent.chop( relativePath.size() + 1 );
+        }
+
+        const int rank( directory->ranks.value( parent, -1 ) );
+        if( rank < 0 || ( matchRank >= 0 && rank >= matchRank ) ) continue;
+        match = parent;
+        matchRank = rank;
+
+    }
+
+    // top level matches are returned relative to path, as done by File::find
+    if( matchRank < 0 ) return File();
+    else if( matchRank == 0 ) return File( file ).addPath( path );
+    else return File( file ).addPath( File( match ) );
+
+}
+
+//__________________________________________________________
+void PixmapPathIndex::_process()
+{
+
+    forever
+    {
+
+        // get next directory
+        File path;
+        int generation = 0;
+        {
+            QMutexLocker lock( &mutex_ );
+            while( pending_.isEmpty() && !abort_ ) condition_.wait( &mutex_ );
+            if( abort_ ) return;
+            path = pending_.front();
+            generation = generation_;
+        }
+
+        Debug::Throw() << "PixmapPathIndex::_process - building " << path << Qt::endl;
+        auto directory( _build( path ) );
+
+        // store, unless path list has changed in the meantime
+        QMutexLocker lock( &mutex_ );
+        if( abort_ ) return;
+        if( generation != generation_ ) continue;
+        pending_.removeOne( path );
+        directories_.insert( path, directory );
+        condition_.wakeAll();
+
+    }
+
+}
+
+//__________________________________________________________
+PixmapPathIndex::DirectoryPtr PixmapPathIndex::_build( const File& path ) const
+{
+
+    std::shared_ptr<Directory> out( new Directory );
+    if( !( path.exists() && path.isDirectory() ) ) return out;
+
+    // directories are visited depth first, in the same order as File::find, using an explicit stack
+    // canonical paths are stored to avoid looping over symbolic links
+    QSet<QString> visited;
+    QStringList directories( { QFileInfo( path ).absoluteFilePath() } );
+    int rank = 0;
+    while( !directories.isEmpty() )
+    {
+
+        // check abort
+        {
+            QMutexLocker lock( &mutex_ );
+            if( abort_ ) return out;
+        }
+
+        const QString directoryPath( directories.takeLast() );
+        const QDir dir( directoryPath );
+        const QString canonicalPath( dir.canonicalPath() );
+        if( canonicalPath.isEmpty() || visited.contains( canonicalPath ) ) continue;
+        visited.insert( canonicalPath );
+        out->ranks.insert( directoryPath, rank++ );
+
+        // files
+        for( const auto& value:dir.entryList( QDir::Files|QDir::Hidden|QDir::System ) )
+        { if( _isImage( value ) ) out->files[value].append( directoryPath ); }
+
+        // sub-directories are pushed in reverse order, so that the first one is visited next
+        const auto children( dir.entryList( QDir::Dirs|QDir::NoDotAndDotDot ) );
+        for( auto&& iter = children.rbegin(); iter != children.rend(); ++iter )
+        { directories.append( QFileInfo( dir, *iter ).absoluteFilePath() ); }
+
+    }
+
+    return out;
+
+}
+
+//__________________________________________________________
+bool PixmapPathIndex::_isImage( const QString& name ) const
+{
+    const int position( name.lastIndexOf( QLatin1Char( '.' ) ) );
+    return position >= 0 && suffixes_.contains( name.mid( position + 1 ).toLower() );
+}
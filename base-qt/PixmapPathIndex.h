@@ -0,0 +1,159 @@
+#ifndef PixmapPathIndex_h
+#define PixmapPathIndex_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "File.h"
+#include "NonCopyable.h"
+#include "base_qt_export.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <memory>
+
+//* index of image files found in pixmap path directories
+/**
+the index is built in a background thread, and rebuilt when the path list changes.
+Lookups give the same result as File::find, without walking directories
+*/
+class BASE_QT_EXPORT PixmapPathIndex final: private Base::Counter<PixmapPathIndex>, private Base::NonCopyable<PixmapPathIndex>
+{
+
+    public:
+
+    //* retrieve singleton
+    static PixmapPathIndex& get();
+
+    //* destructor
+    ~PixmapPathIndex();
+
+    //*@name accessors
+    //@{
+
+    //* true if index matching current path list is complete
+    bool isReady() const;
+
+    //* find file in a given directory and its sub-directories
+    /**
+    same as File( path ).find( file ), using the index when path belongs to the current path list.
+    Paths of the current path list that are not indexed yet are indexed first, and waited for, for at most two seconds.
+    Other paths, or paths not indexed in time, are searched directly. Thread safe
+    */
+    File find( const File& path, const File& file );
+
+    //@}
+
+    //*@name modifiers
+    //@{
+
+    //* set path list. Returns true if changed, in which case the index is rebuilt in the background
+    bool setPathList( const File::List& );
+
+    //@}
+
+    private:
+
+    //* constructor
+    explicit PixmapPathIndex();
+
+    //* indexed directory
+    class Directory
+    {
+        public:
+
+        //* directory rank, in lookup order, indexed by absolute path
+        QHash<QString, int> ranks;
+
+        //* directories, indexed by file name
+        QHash<QString, QStringList> files;
+
+    };
+
+    using DirectoryPtr = std::shared_ptr<const Directory>;
+
+    //* worker thread
+    class Thread: public QThread
+    {
+
+        public:
+
+        //* constructor
+        explicit Thread( PixmapPathIndex& index ):
+            index_( index )
+        {}
+
+        protected:
+
+        //* build pending directories
+        void run() override
+        { index_._process(); }
+
+        private:
+
+        //* parent index
+        PixmapPathIndex& index_;
+
+    };
+
+    //* build pending directories until aborted. Called from worker thread
+    void _process();
+
+    //* build index for a given directory
+    DirectoryPtr _build( const File& ) const;
+
+    //* true if file name has an image suffix
+    bool _isImage( const QString& ) const;
+
+    //* image suffixes
+    QSet<QString> suffixes_;
+
+    //* mutex
+    mutable QMutex mutex_;
+
+    //* wait condition
+    QWaitCondition condition_;
+
+    //* path list
+    File::List pathList_;
+
+    //* directories to be built
+    File::List pending_;
+
+    //* built directories, indexed by path
+    QHash<QString, DirectoryPtr> directories_;
+
+    //* path list generation, used to discard outdated results
+    int generation_ = 0;
+
+    //* abort flag
+    bool abort_ = false;
+
+    //* worker thread
+    std::unique_ptr<Thread> thread_;
+
+};
+
+#endif
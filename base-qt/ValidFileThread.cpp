@@ -20,8 +20,123 @@
 #include "ValidFileThread.h"
 #include "File.h"
 
+#include <QElapsedTimer>
 #include <QMetaType>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+#include <QWaitCondition>
+
 #include <algorithm>
+#include <memory>
+
+namespace
+{
+
+    //* number of threads used for file checks
+    static const int checkThreadCount = 4;
+
+    //* maximum number of threads blocked in abandoned checks
+    static const int maxHungChecks = 16;
+
+    //* pool used for file checks
+    /**
+    it is never deleted, since deleting a pool waits for all running tasks,
+    and tasks might be blocked on hung network mounts
+    */
+    QThreadPool& checkPool()
+    {
+        static QThreadPool* pool = []()
+        {
+            auto pool = new QThreadPool;
+            pool->setMaxThreadCount( checkThreadCount );
+            return pool;
+        }();
+
+        return *pool;
+    }
+
+    //* mutex for hung checks count
+    QMutex& hungChecksMutex()
+    {
+        static QMutex mutex;
+        return mutex;
+    }
+
+    //* number of abandoned checks still blocking a pool thread
+    int& hungChecks()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    //* update number of hung checks
+    /** the pool grows accordingly, so that hung threads are replaced and further checks do not starve */
+    void updateHungChecks( int delta )
+    {
+        QMutexLocker lock( &hungChecksMutex() );
+        hungChecks() += delta;
+        checkPool().setMaxThreadCount( checkThreadCount + hungChecks() );
+    }
+
+    //* true if too many checks are hung for new ones to be dispatched
+    bool tooManyHungChecks()
+    {
+        QMutexLocker lock( &hungChecksMutex() );
+        return hungChecks() >= maxHungChecks;
+    }
+
+    //* state of a single check
+    enum class Status
+    {
+        Pending,
+        Running,
+        Done,
+        Abandoned
+    };
+
+    //* check results, shared between the validity thread and the pool tasks
+    class CheckState
+    {
+        public:
+
+        //* constructor
+        explicit CheckState( int size ):
+            status( size, Status::Pending ),
+            started( size, 0 ),
+            exists( size, false ),
+            canonicalNames( size ),
+            pending( size )
+        { clock.start(); }
+
+        QMutex mutex;
+        QWaitCondition condition;
+        QElapsedTimer clock;
+
+        //* per record status
+        QVector<Status> status;
+
+        //* per record start time
+        QVector<qint64> started;
+
+        //* per record existence
+        QVector<bool> exists;
+
+        //* per record canonical name, computed once
+        QVector<QString> canonicalNames;
+
+        //* records completed since last collected
+        QVector<int> completed;
+
+        //* records being checked
+        QSet<int> running;
+
+        //* number of records not started yet
+        int pending = 0;
+
+    };
+
+}
 
 //______________________________________________________
 ValidFileThread::ValidFileThread( QObject* parent ):
@@ -33,36 +148,163 @@ ValidFileThread::ValidFileThread( QObject* parent ):
 void ValidFileThread::run()
 {
 
-    QMutexLocker lock( &mutex_ );
-    bool hasInvalidRecords( false );
+    // copy settings, so that the lock is not held during the checks
+    FileRecord::List records;
+    bool checkDuplicates;
+    int timeout;
+    {
+        QMutexLocker lock( &mutex_ );
+        records = records_;
+        checkDuplicates = checkDuplicates_;
+        timeout = timeout_;
+    }
 
-    // loop over files, check if exists, set validity accordingly, and post event
-    for( auto& record:records_ )
+    // skip checks when too many pool threads are still blocked by previous ones. Records keep their validity
+    if( tooManyHungChecks() )
     {
-        record.setValid( record.file().exists() );
-        hasInvalidRecords |= !record.isValid();
+        Debug::Throw(0) << "ValidFileThread::run - too many hung file checks. Skipping." << Qt::endl;
+        const bool hasInvalidRecords( std::any_of( records.begin(), records.end(), []( const FileRecord& record ) { return !record.isValid(); } ) );
+        emit recordsAvailable( records, hasInvalidRecords );
+        return;
+    }
+
+    const int size( records.size() );
+    std::shared_ptr<CheckState> state( new CheckState( size ) );
+
+    // dispatch checks
+    for( int index = 0; index < size; ++index )
+    {
+        const File file( records[index].file() );
+        checkPool().start( [state, index, file, checkDuplicates]()
+        {
+            {
+                QMutexLocker lock( &state->mutex );
+                if( state->status[index] == Status::Abandoned ) return;
+                state->status[index] = Status::Running;
+                state->started[index] = state->clock.elapsed();
+                state->running.insert( index );
+                --state->pending;
+            }
+
+            const bool exists( file.exists() );
+            const QString canonicalName( ( checkDuplicates && exists ) ? file.canonicalName().get():QString() );
+
+            QMutexLocker lock( &state->mutex );
+            if( state->status[index] == Status::Abandoned )
+            {
+                // thread is no longer hung
+                updateHungChecks( -1 );
+                return;
+            }
+
+            state->status[index] = Status::Done;
+            state->running.remove( index );
+            state->exists[index] = exists;
+            state->canonicalNames[index] = canonicalName;
+            state->completed.append( index );
+            state->condition.wakeAll();
+        } );
     }
 
-    // look for duplicated records
-    if( checkDuplicates_ && records_.size() > 1 )
+    // collect results
+    bool hasInvalidRecords( false );
+    int finished = 0;
+    qint64 lastProgress = 0;
+    while( finished < size )
     {
 
-        std::sort( records_.begin(), records_.end(), FileRecord::CanonicalFileFTor() );
-        auto&& iter = records_.begin();
-        auto&& previous = iter++;
-        for( ; iter != records_.end(); ++iter )
+        QVector<int> completed;
+        QVector<bool> exists;
         {
-            if( iter->isValid() && iter->canonicalFile() == previous->canonicalFile() )
+            QMutexLocker lock( &state->mutex );
+            if( state->completed.isEmpty() ) state->condition.wait( &state->mutex, 100 );
+
+            completed.swap( state->completed );
+            for( const auto& index:completed )
+            { exists.append( state->exists[index] ); }
+
+            const qint64 now( state->clock.elapsed() );
+            if( !completed.isEmpty() ) lastProgress = now;
+
+            // abandon calls that take too long
+            // they keep their pool thread blocked until they return, and the pool grows to replace it
+            bool abandoned( false );
+            for( auto&& iter = state->running.begin(); iter != state->running.end(); )
             {
-                iter->setValid( false );
-                hasInvalidRecords = true;
-            } else previous = iter;
+                const int index( *iter );
+                if( now - state->started[index] > timeout )
+                {
+                    Debug::Throw() << "ValidFileThread::run - check timed out for " << records[index].file() << Qt::endl;
+                    updateHungChecks( 1 );
+                    state->status[index] = Status::Abandoned;
+                    iter = state->running.erase( iter );
+                    abandoned = true;
+                    ++finished;
+                } else ++iter;
+            }
+
+            // pending checks get a chance to run on the replacement threads
+            if( abandoned ) lastProgress = now;
+
+            // abandon all pending calls when the pool makes no progress, or cannot grow further
+            if( state->pending > 0 && ( now - lastProgress > timeout || tooManyHungChecks() ) )
+            {
+                for( int index = 0; index < size; ++index )
+                {
+                    auto& status( state->status[index] );
+                    if( status != Status::Pending ) continue;
+                    Debug::Throw() << "ValidFileThread::run - check abandoned for " << records[index].file() << Qt::endl;
+                    status = Status::Abandoned;
+                    ++finished;
+                }
+
+                state->pending = 0;
+            }
         }
 
+        if( completed.isEmpty() ) continue;
+        finished += completed.size();
+
+        // send partial results
+        FileRecord::List partial;
+        for( int i = 0; i < completed.size(); ++i )
+        {
+            auto& record( records[completed[i]] );
+            record.setValid( exists[i] );
+            hasInvalidRecords |= !exists[i];
+            partial.append( record );
+        }
+
+        emit partialRecordsAvailable( partial );
+
     }
 
-    emit recordsAvailable( records_, hasInvalidRecords );
+    // look for duplicated records, using canonical names computed once
+    if( checkDuplicates && size > 1 )
+    {
+
+        QVector<int> indices;
+        {
+            QMutexLocker lock( &state->mutex );
+            for( int index = 0; index < size; ++index )
+            { if( state->status[index] == Status::Done && state->exists[index] ) indices.append( index ); }
+
+            std::stable_sort( indices.begin(), indices.end(), [&state]( int first, int second )
+                { return state->canonicalNames[first] < state->canonicalNames[second]; } );
+
+            for( int i = 1; i < indices.size(); ++i )
+            {
+                if( state->canonicalNames[indices[i]] == state->canonicalNames[indices[i-1]] )
+                {
+                    records[indices[i]].setValid( false );
+                    hasInvalidRecords = true;
+                }
+            }
+        }
+
+    }
 
+    emit recordsAvailable( records, hasInvalidRecords );
     return;
 
 }
@@ -28,7 +28,13 @@
 #include <QMutexLocker>
 #include <QThread>
 
-//* independent thread used to automatically save file
+//* independent thread used to check file validity
+/**
+existence checks are dispatched to a small pool of threads. Calls that take longer than the timeout,
+for instance on a hung network mount, are abandoned and the corresponding records keep their previous validity.
+The pool grows to replace threads blocked by abandoned checks, up to a maximum, past which checks are skipped.
+Partial results are sent as they become available
+*/
 class BASE_QT_EXPORT ValidFileThread: public QThread, private Base::Counter<ValidFileThread>
 {
 
@@ -53,8 +59,18 @@ class BASE_QT_EXPORT ValidFileThread: public QThread, private Base::Counter<Vali
         records_ = records;
     }
 
+    //* timeout for a single file check (ms)
+    void setTimeout( int value )
+    {
+        QMutexLocker lock( &mutex_ );
+        timeout_ = value;
+    }
+
     Q_SIGNALS:
 
+    //* records checked so far, without duplicate check
+    void partialRecordsAvailable( const FileRecord::List& );
+
     //* records are available
     void recordsAvailable( const FileRecord::List&, bool );
 
@@ -71,6 +87,9 @@ class BASE_QT_EXPORT ValidFileThread: public QThread, private Base::Counter<Vali
     //* check duplicates
     bool checkDuplicates_ = true;
 
+    //* timeout for a single file check (ms)
+    int timeout_ = 2000;
+
     //* list of records to be checked
     FileRecord::List records_;
 
@@ -0,0 +1,369 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "XmlBinaryCache.h"
+#include "Debug.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStringList>
+
+#include <memory>
+
+namespace
+{
+
+    //* magic number
+    static const quint32 magic = 0x42584331;
+
+    //* format version. To be incremented on any format change
+    static const quint16 version = 1;
+
+    //* content type
+    enum class Type: quint8
+    {
+        Options = 1,
+        Records = 2
+    };
+
+    //* data stream version, fixed so that Qt5 and Qt6 builds share caches
+    static const int streamVersion = QDataStream::Qt_5_15;
+
+    //* source stamp
+    class Stamp
+    {
+        public:
+
+        //* constructor
+        explicit Stamp( const File& file )
+        {
+            const QFileInfo info( file );
+            if( !info.exists() ) return;
+            modified = info.lastModified().toMSecsSinceEpoch();
+            size = info.size();
+        }
+
+        //* modification time
+        qint64 modified = -1;
+
+        //* size
+        qint64 size = -1;
+
+    };
+
+    //* string table, used for writing
+    class StringTable
+    {
+        public:
+
+        //* index for a given string, inserted if needed
+        quint32 index( const QString& value )
+        {
+            auto iter( indices_.constFind( value ) );
+            if( iter != indices_.constEnd() ) return iter.value();
+
+            const quint32 out( strings_.size() );
+            indices_.insert( value, out );
+            strings_.append( value );
+            return out;
+        }
+
+        //* strings
+        const QStringList& strings() const
+        { return strings_; }
+
+        private:
+
+        //* indices
+        QHash<QString, quint32> indices_;
+
+        //* strings
+        QStringList strings_;
+
+    };
+
+    //* memory mapped cache file, with header validated
+    class Reader
+    {
+        public:
+
+        //* constructor
+        explicit Reader( const File& source, const QString& tagName, Type type ):
+            file_( XmlBinaryCache::cacheFile( source, tagName ) )
+        {
+
+            if( !( XmlBinaryCache::isEnabled() && file_.open( QIODevice::ReadOnly ) ) ) return;
+            const auto size( file_.size() );
+            if( size <= 0 ) return;
+
+            data_ = file_.map( 0, size );
+            if( !data_ ) return;
+
+            buffer_ = QByteArray::fromRawData( reinterpret_cast<const char*>( data_ ), int( size ) );
+            stream_.reset( new QDataStream( buffer_ ) );
+            stream_->setVersion( streamVersion );
+
+            // header
+            quint32 fileMagic = 0;
+            quint16 fileVersion = 0;
+            quint8 fileType = 0;
+            qint64 modified = 0;
+            qint64 sourceSize = 0;
+            QString fileTagName;
+            *stream_ >> fileMagic >> fileVersion >> fileType >> modified >> sourceSize >> fileTagName;
+            if( stream_->status() != QDataStream::Ok ) return;
+            if( fileMagic != magic || fileVersion != version || fileType != quint8( type ) || fileTagName != tagName ) return;
+
+            // compare to source
+            const Stamp stamp( source );
+            if( stamp.modified != modified || stamp.size != sourceSize ) return;
+
+            // string table
+            quint32 count = 0;
+            *stream_ >> count;
+            if( stream_->status() != QDataStream::Ok || count > quint32( size ) ) return;
+
+            strings_.reserve( count );
+            for( quint32 i = 0; i < count; ++i )
+            {
+                QString value;
+                *stream_ >> value;
+                strings_.append( value );
+            }
+
+            valid_ = stream_->status() == QDataStream::Ok;
+
+        }
+
+        //* destructor
+        ~Reader()
+        {
+            stream_.reset();
+            if( data_ ) file_.unmap( data_ );
+        }
+
+        //* validity
+        bool isValid() const
+        { return valid_ && stream_->status() == QDataStream::Ok; }
+
+        //* stream
+        QDataStream& stream()
+        { return *stream_; }
+
+        //* string from index
+        QString string( quint32 index )
+        {
+            if( index < quint32( strings_.size() ) ) return strings_[index];
+            valid_ = false;
+            return QString();
+        }
+
+        private:
+
+        //* file
+        QFile file_;
+
+        //* mapped data
+        uchar* data_ = nullptr;
+
+        //* raw buffer, pointing to mapped data
+        QByteArray buffer_;
+
+        //* stream
+        std::unique_ptr<QDataStream> stream_;
+
+        //* strings
+        QStringList strings_;
+
+        //* validity
+        bool valid_ = false;
+
+    };
+
+    //* write cache file
+    bool writeCache( const File& source, const QString& tagName, Type type, const StringTable& strings, const QByteArray& payload )
+    {
+
+        if( !XmlBinaryCache::isEnabled() ) return false;
+
+        const Stamp stamp( source );
+        if( stamp.modified < 0 ) return false;
+
+        QSaveFile out( XmlBinaryCache::cacheFile( source, tagName ) );
+        if( !out.open( QIODevice::WriteOnly ) ) return false;
+
+        QDataStream stream( &out );
+        stream.setVersion( streamVersion );
+        stream << magic << version << quint8( type ) << stamp.modified << stamp.size << tagName;
+
+        stream << quint32( strings.strings().size() );
+        for( const auto& value:strings.strings() )
+        { stream << value; }
+
+        stream.writeRawData( payload.constData(), payload.size() );
+        if( stream.status() != QDataStream::Ok ) return false;
+        return out.commit();
+
+    }
+
+}
+
+//________________________________________________________________
+bool& XmlBinaryCache::_enabled()
+{
+    static bool enabled = false;
+    return enabled;
+}
+
+//________________________________________________________________
+File XmlBinaryCache::cacheFile( const File& file, const QString& tagName )
+{ return File( QStringLiteral( "%1.%2.cache" ).arg( file.get(), tagName ) ); }
+
+//________________________________________________________________
+bool XmlBinaryCache::read( const File& file, const QString& tagName, OptionEntry::List& entries )
+{
+
+    Reader reader( file, tagName, Type::Options );
+    if( !reader.isValid() ) return false;
+
+    auto& stream( reader.stream() );
+    quint32 count = 0;
+    stream >> count;
+
+    OptionEntry::List out;
+    for( quint32 i = 0; i < count && reader.isValid(); ++i )
+    {
+        quint8 keep = 0;
+        quint32 name = 0;
+        QByteArray raw;
+        quint32 flags = 0;
+        stream >> keep >> name >> raw >> flags;
+
+        OptionEntry entry;
+        entry.keep = keep;
+        entry.option.setName( reader.string( name ) );
+        entry.option.setRaw( raw );
+        entry.option.setFlags( (Option::Flags) int( flags ) );
+        out.append( entry );
+    }
+
+    if( !reader.isValid() ) return false;
+
+    Debug::Throw() << "XmlBinaryCache::read - " << tagName << " options: " << out.size() << Qt::endl;
+    entries = out;
+    return true;
+
+}
+
+//________________________________________________________________
+bool XmlBinaryCache::read( const File& file, const QString& tagName, FileRecord::List& records )
+{
+
+    Reader reader( file, tagName, Type::Records );
+    if( !reader.isValid() ) return false;
+
+    auto& stream( reader.stream() );
+    quint32 count = 0;
+    stream >> count;
+
+    FileRecord::List out;
+    for( quint32 i = 0; i < count && reader.isValid(); ++i )
+    {
+        quint32 name = 0;
+        qint64 time = 0;
+        qint32 flags = 0;
+        quint8 valid = 0;
+        quint32 propertyCount = 0;
+        stream >> name >> time >> flags >> valid >> propertyCount;
+
+        FileRecord record( File( reader.string( name ) ), TimeStamp( time_t( time ) ) );
+        record.setFlags( flags );
+        record.setValid( valid );
+        for( quint32 j = 0; j < propertyCount && reader.isValid(); ++j )
+        {
+            quint32 propertyName = 0;
+            quint32 propertyValue = 0;
+            stream >> propertyName >> propertyValue;
+            record.addProperty( reader.string( propertyName ), reader.string( propertyValue ) );
+        }
+
+        out.append( record );
+    }
+
+    if( !reader.isValid() ) return false;
+
+    Debug::Throw() << "XmlBinaryCache::read - " << tagName << " records: " << out.size() << Qt::endl;
+    records = out;
+    return true;
+
+}
+
+//________________________________________________________________
+bool XmlBinaryCache::write( const File& file, const QString& tagName, const OptionEntry::List& entries )
+{
+
+    if( !isEnabled() ) return false;
+
+    StringTable strings;
+    QByteArray payload;
+    {
+        QDataStream stream( &payload, QIODevice::WriteOnly );
+        stream.setVersion( streamVersion );
+        stream << quint32( entries.size() );
+        for( const auto& entry:entries )
+        { stream << quint8( entry.keep ) << strings.index( entry.option.name() ) << entry.option.raw() << quint32( entry.option.flags() ); }
+    }
+
+    return writeCache( file, tagName, Type::Options, strings, payload );
+
+}
+
+//________________________________________________________________
+bool XmlBinaryCache::write( const File& file, const QString& tagName, const FileRecord::List& records )
+{
+
+    if( !isEnabled() ) return false;
+
+    StringTable strings;
+    QByteArray payload;
+    {
+        QDataStream stream( &payload, QIODevice::WriteOnly );
+        stream.setVersion( streamVersion );
+        stream << quint32( records.size() );
+        for( const auto& record:records )
+        {
+            stream
+                << strings.index( record.file() )
+                << qint64( record.time().unixTime() )
+                << qint32( record.flags() )
+                << quint8( record.isValid() )
+                << quint32( record.properties().size() );
+
+            const auto& properties( record.properties() );
+            for( auto iter = properties.begin(); iter != properties.end(); ++iter )
+            { stream << strings.index( FileRecord::PropertyId::get( iter.key() ) ) << strings.index( iter.value() ); }
+        }
+    }
+
+    return writeCache( file, tagName, Type::Records, strings, payload );
+
+}
@@ -0,0 +1,105 @@
+#ifndef XmlBinaryCache_h
+#define XmlBinaryCache_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "File.h"
+#include "FileRecord.h"
+#include "XmlOption.h"
+#include "base_qt_export.h"
+
+#include <QList>
+#include <QString>
+
+//* binary sidecar cache for xml resource files
+/**
+sections read from xml resource files are stored in a compact binary file, next to the xml file.
+The cache is versioned, uses a string table so that repeated names are stored once, and is
+validated against the modification time and size of the xml file, which remains the source of truth.
+Cache files are memory mapped when read.
+
+The cache for a given section is written next to the xml file, and named after it, e.g.
+~/.applicationrc.options.cache for the options section of ~/.applicationrc.
+The cache is disabled by default, so that no such file is created unless the application
+enables it explicitly, using setEnabled, before the first read
+*/
+class BASE_QT_EXPORT XmlBinaryCache
+{
+
+    public:
+
+    //* option entry, as read from xml
+    class BASE_QT_EXPORT OptionEntry
+    {
+
+        public:
+
+        //* true for special option declarations
+        bool keep = false;
+
+        //* option. For special option declarations only the name is used
+        XmlOption option;
+
+        //* list
+        using List = QList<OptionEntry>;
+
+    };
+
+    //*@name accessors
+    //@{
+
+    //* true if enabled. Default is false
+    static bool isEnabled()
+    { return _enabled(); }
+
+    //* cache file matching a given xml file and section
+    static File cacheFile( const File&, const QString& );
+
+    //* read options. Returns false if the cache is missing or out of date
+    static bool read( const File&, const QString&, OptionEntry::List& );
+
+    //* read file records. Returns false if the cache is missing or out of date
+    static bool read( const File&, const QString&, FileRecord::List& );
+
+    //@}
+
+    //*@name modifiers
+    //@{
+
+    //* enable. When disabled, existing cache files are neither read nor updated
+    static void setEnabled( bool value )
+    { _enabled() = value; }
+
+    //* write options. Must be called after the xml file is written
+    static bool write( const File&, const QString&, const OptionEntry::List& );
+
+    //* write file records. Must be called after the xml file is written
+    static bool write( const File&, const QString&, const FileRecord::List& );
+
+    //@}
+
+    private:
+
+    //* enabled flag
+    static bool& _enabled();
+
+};
+
+#endif
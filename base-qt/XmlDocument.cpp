@@ -25,9 +25,16 @@
 //___________________________________________________________________
 XmlDocument::XmlDocument():
     Counter( QStringLiteral("XmlDocument") ),
-    topNodeTagName_( QStringLiteral("Resources") )
+    topNodeTagName_( topNodeTagName() )
 {}
 
+//___________________________________________________________________
+const QString& XmlDocument::topNodeTagName()
+{
+    static const QString tagName( QStringLiteral("Resources") );
+    return tagName;
+}
+
 //___________________________________________________________________
 void XmlDocument::replaceChild( QDomElement& element )
 {
@@ -55,6 +55,9 @@ class BASE_QT_EXPORT XmlDocument final: private Base::Counter<XmlDocument>
     const XmlError& error() const
     { return error_; }
 
+    //* document node name
+    static const QString& topNodeTagName();
+
     //@}
 
     //*@name modifiers
@@ -20,6 +20,7 @@
 #include "XmlFileList.h"
 #include "Debug.h"
 #include "Operators.h"
+#include "XmlBinaryCache.h"
 #include "XmlDocument.h"
 #include "XmlFileRecord.h"
 
@@ -30,10 +31,12 @@
 //_______________________________________________
 XmlFileList::XmlFileList( QObject* parent ):
     FileList( parent ),
-    tagName_( Base::Xml::FileList )
+    tagName_( Base::Xml::FileList ),
+    thread_( new XmlFileRecordThread( this ) )
 {
 
     Debug::Throw( QStringLiteral("XmlFileList::XmlFileList.\n") );
+    connect( thread_.get(), &XmlFileRecordThread::recordsAvailable, this, &XmlFileList::_processRecords );
     connect( qApp, &QApplication::aboutToQuit, this, QOverload<>::of( &XmlFileList::write ) );
 
 }
@@ -58,7 +61,7 @@ bool XmlFileList::setDBFile( const File& file )
     Debug::Throw() << "XmlFileList::_setDBFile - file: " << file << Qt::endl;
 
     // check file
-    if( dbFile_ == file && !_records().isEmpty() ) return false;
+    if( dbFile_ == file && ( readPending_ || !_records().isEmpty() ) ) return false;
 
     // store file and read
     dbFile_ = file;
@@ -67,7 +70,8 @@ bool XmlFileList::setDBFile( const File& file )
     if( dbFile_.localName().startsWith( '.' ) )
     { dbFile_.setHidden(); }
 
-    read();
+    // records are merged when available, and contentsChanged is emitted
+    readAsync();
 
     return true;
 
@@ -78,26 +82,75 @@ bool XmlFileList::read( File file )
 {
     Debug::Throw( QStringLiteral("XmlFileList::read.\n") );
 
+    // supersedes asynchronous read, if any. Files removed while it was pending are not merged back
+    QSet<QString> removedFiles;
+    if( readPending_ ) removedFiles.swap( removedFiles_ );
+    readPending_ = false;
+    removedFiles_.clear();
+
     if( file.isEmpty() ) file = dbFile_;
     if( file.isEmpty() || !file.exists() ) return false;
 
-    // parse the file
-    XmlDocument document;
-    QFile qfile( file );
-    if( !qfile.open( QIODevice::ReadOnly ) ) return false;
-    if ( !document.setContent( &qfile ) )
+    // try binary cache, then parse the file
+    FileRecord::List records;
+    if( !XmlBinaryCache::read( file, tagName_, records ) )
     {
+        QFile qfile( file );
+        if( !qfile.open( QIODevice::ReadOnly ) ) return false;
+        if( !XmlFileRecord::Helper::read( &qfile, tagName_, records ) ) return false;
+        qfile.close();
+        XmlBinaryCache::write( file, tagName_, records );
+    }
 
-        Debug::Throw() << document.error() << Qt::endl;
-        return false;
+    for( const auto& record:records )
+    { if( !removedFiles.contains( record.file() ) ) _add( record, true, false ); }
 
-    } else if( _read( document ) ) {
+    emit contentsChanged();
+    return true;
 
-        emit contentsChanged();
-        return true;
+}
 
-    } else return false;
+//_______________________________________________
+void XmlFileList::readAsync( File file )
+{
+    Debug::Throw( QStringLiteral("XmlFileList::readAsync.\n") );
 
+    if( file.isEmpty() ) file = dbFile_;
+    if( file.isEmpty() || !file.exists() ) return;
+    if( thread_->isRunning() ) thread_->wait();
+
+    readPending_ = true;
+    removedFiles_.clear();
+    thread_->setFile( file, tagName_, ++readGeneration_ );
+    thread_->start();
+}
+
+//_______________________________________________
+void XmlFileList::_filesRemoved( const File::List& files )
+{
+    if( !readPending_ ) return;
+    for( const auto& file:files )
+    { removedFiles_.insert( file ); }
+}
+
+//_______________________________________________
+void XmlFileList::_processRecords( quint32 generation, const FileRecord::List& records, bool valid )
+{
+    Debug::Throw( QStringLiteral("XmlFileList::_processRecords.\n") );
+
+    // drop results from superseded reads, for instance from a previous db file
+    if( !( readPending_ && generation == readGeneration_ ) ) return;
+    readPending_ = false;
+
+    QSet<QString> removedFiles;
+    removedFiles.swap( removedFiles_ );
+    if( !valid ) return;
+
+    // do not merge back files removed while reading
+    for( const auto& record:records )
+    { if( !removedFiles.contains( record.file() ) ) _add( record, true, false ); }
+
+    emit contentsChanged();
 }
 
 //_______________________________________________
@@ -134,6 +187,9 @@ bool XmlFileList::write( File file )
     if( file.isEmpty() ) file = dbFile_;
     if( file.isEmpty() ) return false;
 
+    // make sure records read asynchronously are merged before writing
+    if( readPending_ ) read();
+
     // create document and read
     XmlDocument document;
     {
@@ -152,11 +208,15 @@ bool XmlFileList::write( File file )
 
     // create main element and insert records
     auto top = document.createElement( tagName_ );
+    FileRecord::List written;
     for( const auto& record:records )
     {
 
         if( !record.file().isEmpty() )
-        { top.appendChild( XmlFileRecord( record ).domElement( document.get() ) ); }
+        {
+            top.appendChild( XmlFileRecord( record ).domElement( document.get() ) );
+            written.append( record );
+        }
 
     }
 
@@ -168,6 +228,7 @@ bool XmlFileList::write( File file )
         qfile.write( document.toByteArray() );
     }
 
+    XmlBinaryCache::write( file, tagName_, written );
     return true;
 }
 
@@ -22,8 +22,11 @@
 
 #include "File.h"
 #include "FileList.h"
+#include "ThreadDeleter.h"
+#include "XmlFileRecordThread.h"
 #include "base_qt_export.h"
 
+#include <QSet>
 #include <QString>
 
 // forward declaration
@@ -48,6 +51,10 @@ class BASE_QT_EXPORT XmlFileList: public FileList
     void setTagName( const QString& );
 
     //* set db file
+    /**
+    records are read in a separate thread, and merged into the list when available, at which point contentsChanged is emitted.
+    The list does not contain the file records when this method returns. Callers that need them immediately must call read()
+    */
     bool setDBFile( const File& );
 
     //@}
@@ -55,6 +62,10 @@ class BASE_QT_EXPORT XmlFileList: public FileList
     //* Read fileList from file
     bool read( File = File() );
 
+    //* Read fileList from file, in a separate thread
+    /** records are merged into the list when available */
+    void readAsync( File = File() );
+
     //* write fileList to file
     inline bool write() { return write( File() ); }
     bool write( File );
@@ -64,8 +75,14 @@ class BASE_QT_EXPORT XmlFileList: public FileList
     //* read
     bool _read( const XmlDocument& );
 
+    //* called when files are removed from the list
+    void _filesRemoved( const File::List& ) override;
+
     private:
 
+    //* process records read from thread, for a given generation
+    void _processRecords( quint32, const FileRecord::List&, bool );
+
     //* compare two record lists
     bool _differs( const FileRecord::List&, const FileRecord::List& ) const;
 
@@ -75,5 +92,17 @@ class BASE_QT_EXPORT XmlFileList: public FileList
     //* file from/to wich the files are saved
     File dbFile_;
 
+    //* true if records read asynchronously have not been merged yet
+    bool readPending_ = false;
+
+    //* generation of the last asynchronous read. Results from other generations are dropped
+    quint32 readGeneration_ = 0;
+
+    //* files removed while an asynchronous read is pending. They are not merged back
+    QSet<QString> removedFiles_;
+
+    //* thread used to read records
+    std::unique_ptr<XmlFileRecordThread, Base::ThreadDeleter> thread_;
+
 };
 #endif
@@ -77,6 +77,45 @@ XmlFileRecord::XmlFileRecord( const QDomElement& element )
 
 }
 
+//_______________________________________________
+XmlFileRecord::XmlFileRecord( QXmlStreamReader& reader )
+{
+
+    // load attributes
+    for( const auto& attribute:reader.attributes() )
+    {
+        const auto name( attribute.name() );
+        if( name == Base::Xml::File ) setFile( File( attribute.value().toString() ) );
+        else if( name == Base::Xml::Time ) setTime( TimeStamp( attribute.value().toInt() ) );
+        else if( name == Base::Xml::Flags ) setFlags( attribute.value().toUInt() );
+        else if( name == Base::Xml::Valid ) setValid( attribute.value().toInt() );
+        else addProperty( name.toString(), attribute.value().toString() );
+    }
+
+    // parse children elements
+    while( reader.readNextStartElement() )
+    {
+        if( reader.name() == Base::Xml::Property )
+        {
+
+            // load attributes
+            std::pair<QString,QString> property;
+            for( const auto& attribute:reader.attributes() )
+            {
+                if( attribute.name() == Base::Xml::Name ) property.first = attribute.value().toString();
+                else if( attribute.name() == Base::Xml::Value ) property.second = attribute.value().toString();
+            }
+
+            if( !( property.first.isEmpty() || property.second.isEmpty() ) )
+            { addProperty( property.first, property.second ); }
+
+        }
+
+        reader.skipCurrentElement();
+    }
+
+}
+
 //_______________________________________________
 QDomElement XmlFileRecord::domElement( QDomDocument& parent ) const
 {
@@ -135,3 +174,35 @@ QDomElement XmlFileRecord::Helper::domElement( const List& list, QDomDocument& d
     }
     return top;
 }
+
+//_______________________________________________
+bool XmlFileRecord::Helper::read( QIODevice* device, const QString& tagName, FileRecord::List& records )
+{
+    Debug::Throw( QStringLiteral("XmlFileRecord::Helper::read.\n") );
+
+    QXmlStreamReader reader( device );
+    reader.setNamespaceProcessing( false );
+
+    // look for relevant element
+    while( !reader.atEnd() )
+    {
+
+        if( reader.readNext() != QXmlStreamReader::StartElement || reader.name() != tagName ) continue;
+
+        // records are constructed while parsing
+        while( reader.readNextStartElement() )
+        {
+            if( reader.name() == Base::Xml::Record )
+            {
+                XmlFileRecord record( reader );
+                if( !record.file().isEmpty() ) records.append( record );
+            } else reader.skipCurrentElement();
+        }
+
+        return !reader.hasError();
+
+    }
+
+    return false;
+
+}
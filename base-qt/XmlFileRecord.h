@@ -25,7 +25,9 @@
 
 #include <QDomElement>
 #include <QDomDocument>
+#include <QIODevice>
 #include <QString>
+#include <QXmlStreamReader>
 
 namespace Base
 {
@@ -53,6 +55,10 @@ class BASE_QT_EXPORT XmlFileRecord: public FileRecord
     //* constructor
     explicit XmlFileRecord( const QDomElement& );
 
+    //* constructor from stream, positioned on the record start element
+    /** on return, the reader is positioned on the matching end element */
+    explicit XmlFileRecord( QXmlStreamReader& );
+
     //* write to dom
     QDomElement domElement( QDomDocument& ) const;
 
@@ -67,6 +73,10 @@ class BASE_QT_EXPORT XmlFileRecord: public FileRecord
         //* write to dom
         static QDomElement domElement( const List&, QDomDocument& );
 
+        //* read records from the first element matching a given tag name
+        /** returns false if the element is not found or the input cannot be parsed */
+        static bool read( QIODevice*, const QString&, FileRecord::List& );
+
     };
 
 };
@@ -0,0 +1,61 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "XmlFileRecordThread.h"
+#include "XmlBinaryCache.h"
+#include "XmlFileRecord.h"
+
+#include <QFile>
+#include <QMetaType>
+
+//______________________________________________________
+XmlFileRecordThread::XmlFileRecordThread( QObject* parent ):
+    QThread( parent ),
+    Counter( QStringLiteral("XmlFileRecordThread") )
+{ qRegisterMetaType<FileRecord::List>( "FileRecord::List" ); }
+
+//______________________________________________________
+void XmlFileRecordThread::run()
+{
+
+    File file;
+    QString tagName;
+    quint32 generation;
+    {
+        QMutexLocker lock( &mutex_ );
+        file = file_;
+        tagName = tagName_;
+        generation = generation_;
+    }
+
+    // try binary cache, then parse the file
+    FileRecord::List records;
+    if( XmlBinaryCache::read( file, tagName, records ) )
+    {
+        emit recordsAvailable( generation, records, true );
+        return;
+    }
+
+    QFile qfile( file );
+    const bool valid( qfile.open( QIODevice::ReadOnly ) && XmlFileRecord::Helper::read( &qfile, tagName, records ) );
+    qfile.close();
+    if( valid ) XmlBinaryCache::write( file, tagName, records );
+    emit recordsAvailable( generation, records, valid );
+
+}
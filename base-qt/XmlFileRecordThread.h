@@ -0,0 +1,77 @@
+#ifndef XmlFileRecordThread_h
+#define XmlFileRecordThread_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "File.h"
+#include "FileRecord.h"
+#include "base_qt_export.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+//* independent thread used to read file records from xml
+class BASE_QT_EXPORT XmlFileRecordThread: public QThread, private Base::Counter<XmlFileRecordThread>
+{
+
+    Q_OBJECT
+
+    public:
+
+    //* constructor
+    explicit XmlFileRecordThread( QObject* = nullptr );
+
+    //* set file and tag name, and generation used to tag the result
+    void setFile( const File& file, const QString& tagName, quint32 generation )
+    {
+        QMutexLocker lock( &mutex_ );
+        file_ = file;
+        tagName_ = tagName;
+        generation_ = generation;
+    }
+
+    Q_SIGNALS:
+
+    //* records are available, for a given generation. Last argument is false if the file could not be read
+    void recordsAvailable( quint32, const FileRecord::List&, bool );
+
+    protected:
+
+    //* read records
+    void run() override;
+
+    private:
+
+    //* mutex
+    QMutex mutex_;
+
+    //* file
+    File file_;
+
+    //* tag name
+    QString tagName_;
+
+    //* generation
+    quint32 generation_ = 0;
+
+};
+#endif
@@ -64,6 +64,35 @@ XmlOption::XmlOption( const QDomElement& element )
 
 }
 
+//________________________________________________
+XmlOption::XmlOption( QXmlStreamReader& reader )
+{
+
+    // old implementation (kept for backward compatibility
+    // element name is option name
+    if( reader.name() != Base::Xml::Option ) setName( reader.name().toString() );
+
+    // parse attributes
+    for( const auto& attribute:reader.attributes() )
+    {
+        const auto name( attribute.name() );
+        if( name == Base::Xml::Name ) setName( attribute.value().toString() );
+        else if( name == Base::Xml::Value ) setRaw( attribute.value().toString() );
+        else if( name == Base::Xml::Flags ) setFlags( (Option::Flags) attribute.value().toInt() );
+    }
+
+    // parse children elements
+    while( reader.readNextStartElement() )
+    {
+        const auto name( reader.name() );
+        if( name == Base::Xml::Name ) setName( reader.readElementText() );
+        else if( name == Base::Xml::Value ) setRaw( reader.readElementText() );
+        else if( name == Base::Xml::Flags ) setFlags( (Option::Flags) reader.readElementText().toInt() );
+        else reader.skipCurrentElement();
+    }
+
+}
+
 //________________________________________________
 QDomElement XmlOption::domElement( QDomDocument& document ) const
 {
@@ -78,3 +107,17 @@ QDomElement XmlOption::domElement( QDomDocument& document ) const
     return out;
 
 }
+
+//________________________________________________
+void XmlOption::write( QXmlStreamWriter& writer ) const
+{
+
+    Debug::Throw() << "XmlOption::write - " << name() << " - " << raw() << Qt::endl;
+
+    writer.writeStartElement( Base::Xml::Option );
+    writer.writeAttribute( Base::Xml::Name, name() );
+    writer.writeAttribute( Base::Xml::Flags, QString::number( flags() ) );
+    writer.writeAttribute( Base::Xml::Value, QString::fromUtf8( raw() ) );
+    writer.writeEndElement();
+
+}
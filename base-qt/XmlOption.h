@@ -26,6 +26,8 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QString>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 namespace Base
 {
@@ -61,9 +63,16 @@ class BASE_QT_EXPORT XmlOption:public Option
     //* constructor from DOM node
     explicit XmlOption( const QDomElement& );
 
+    //* constructor from stream, positioned on the option start element
+    /** on return, the reader is positioned on the matching end element */
+    explicit XmlOption( QXmlStreamReader& );
+
     //* create dom element
     QDomElement domElement( QDomDocument& ) const;
 
+    //* write element to stream
+    void write( QXmlStreamWriter& ) const;
+
     //* name
     void setName( const QString& value )
     { name_ = value; }
@@ -20,13 +20,179 @@
 #include "XmlOptions.h"
 #include "Operators.h"
 #include "Options.h"
+#include "StartupProfiler.h"
 #include "XmlDocument.h"
 #include "XmlOption.h"
 #include "XmlOptions_p.h"
 
 
+#include <QBuffer>
+#include <QDateTime>
 #include <QFile>
+#include <QFileInfo>
+#include <QPair>
 #include <QRegularExpression>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+
+namespace
+{
+
+    //* recordable options, as written to file
+    XmlBinaryCache::OptionEntry::List optionEntries( const Options& options )
+    {
+
+        XmlBinaryCache::OptionEntry::List entries;
+
+        // special options
+        for( auto&& iter = options.specialOptions().begin(); iter != options.specialOptions().end(); ++iter )
+        {
+
+            for( const auto& option:iter.value() )
+            {
+
+                if( option.hasFlag( Option::Flag::Recordable ) && option.isSet() )
+                {
+                    XmlBinaryCache::OptionEntry entry;
+                    entry.option = XmlOption( iter.key(), option );
+                    entries.append( entry );
+                }
+
+            }
+
+        }
+
+        // standard options
+        for( auto&& iter = options.options().begin(); iter != options.options().end(); ++iter )
+        {
+
+            if( iter.value().hasFlag( Option::Flag::Recordable ) && iter.value().isSet() && !iter.value().isDefault() )
+            {
+                XmlBinaryCache::OptionEntry entry;
+                entry.option = XmlOption( iter.key(), iter.value() );
+                entries.append( entry );
+            }
+
+        }
+
+        return entries;
+
+    }
+
+    //* write options element
+    void writeOptions( QXmlStreamWriter& writer, const XmlBinaryCache::OptionEntry::List& entries )
+    {
+
+        writer.writeStartElement( Base::Xml::Options );
+        for( const auto& entry:entries )
+        { entry.option.write( writer ); }
+        writer.writeEndElement();
+
+    }
+
+    //* start document
+    void startDocument( QXmlStreamWriter& writer )
+    {
+        writer.setAutoFormatting( true );
+        writer.setAutoFormattingIndent( 1 );
+        writer.writeStartDocument();
+        writer.writeStartElement( XmlDocument::topNodeTagName() );
+    }
+
+    //* end document
+    void endDocument( QXmlStreamWriter& writer )
+    {
+        writer.writeEndElement();
+        writer.writeEndDocument();
+    }
+
+    //* copy current element and its children to both writers
+    void copyElement( QXmlStreamReader& reader, QXmlStreamWriter& writer, QXmlStreamWriter& foreignWriter )
+    {
+        int depth = 0;
+        forever
+        {
+            if( reader.isStartElement() ) ++depth;
+            else if( reader.isEndElement() ) --depth;
+
+            // indentation is handled by the writers
+            if( !reader.isWhitespace() )
+            {
+                writer.writeCurrentToken( reader );
+                foreignWriter.writeCurrentToken( reader );
+            }
+
+            if( depth <= 0 || reader.atEnd() ) return;
+            reader.readNext();
+        }
+    }
+
+    //* write document with given options
+    /**
+    sections of the input, if any, other than options are copied as is, and also stored in foreign,
+    with an empty options element in place of the options, for use as input of the next write.
+    Returns false if the input cannot be parsed
+    */
+    bool writeDocument( QByteArray& content, QByteArray& foreign, const XmlBinaryCache::OptionEntry::List& entries, QIODevice* input )
+    {
+
+        QXmlStreamWriter writer( &content );
+        startDocument( writer );
+
+        QXmlStreamWriter foreignWriter( &foreign );
+        startDocument( foreignWriter );
+
+        bool optionsWritten = false;
+        if( input )
+        {
+
+            QXmlStreamReader reader( input );
+            if( !reader.readNextStartElement() || reader.name() != XmlDocument::topNodeTagName() ) return false;
+
+            while( reader.readNextStartElement() )
+            {
+                if( reader.name() == Base::Xml::Options )
+                {
+
+                    // options are written in place of the previous ones
+                    if( !optionsWritten )
+                    {
+                        writeOptions( writer, entries );
+                        foreignWriter.writeEmptyElement( Base::Xml::Options );
+                    }
+
+                    optionsWritten = true;
+                    reader.skipCurrentElement();
+
+                } else copyElement( reader, writer, foreignWriter );
+            }
+
+            if( reader.hasError() ) return false;
+
+        }
+
+        if( !optionsWritten )
+        {
+            writeOptions( writer, entries );
+            foreignWriter.writeEmptyElement( Base::Xml::Options );
+        }
+
+        endDocument( writer );
+        endDocument( foreignWriter );
+        return true;
+
+    }
+
+    //* file modification time (ms) and size, or -1 if not found
+    QPair<qint64, qint64> fileStamp( const File& file )
+    {
+        const QFileInfo info( file );
+        if( !info.exists() ) return qMakePair( qint64(-1), qint64(-1) );
+        return qMakePair( info.lastModified().toMSecsSinceEpoch(), info.size() );
+    }
+
+}
 
 //____________________________________________________________________
 Private::XmlOptionsSingleton& XmlOptions::_singleton()
@@ -38,6 +204,20 @@ Private::XmlOptionsSingleton& XmlOptions::_singleton()
 namespace Private
 {
 
+    //____________________________________________________________________
+    bool XmlOptionsSingleton::isModified()
+    {
+
+        if( !hasWritten_ ) return true;
+        if( options_.revision() == writtenRevision_ ) return false;
+        if( differs( written_ ) ) return true;
+
+        // modifications did not change any recordable option
+        writtenRevision_ = options_.revision();
+        return false;
+
+    }
+
     //____________________________________________________________________
     bool XmlOptionsSingleton::_differs( const Options& first, const Options& second ) const
     {
@@ -116,15 +296,49 @@ Options& XmlOptions::get()
 bool XmlOptions::read()
 {
 
+    StartupProfiler::Scope scope( "XmlOptions::read" );
+
     // check filename is valid
-    if( _singleton().file().isEmpty() ) return false;
+    const File& file( _singleton().file() );
+    if( file.isEmpty() ) return false;
+
+    auto& error( _singleton().error_ );
+    error.clear();
+
+    // try binary cache first
+    XmlBinaryCache::OptionEntry::List entries;
+    if( XmlBinaryCache::read( file, Base::Xml::Options, entries ) )
+    {
+        _apply( _singleton().options_, entries );
+        _singleton().setWritten();
+        return true;
+    }
 
     // parse the file
-    XmlDocument document;
-    QFile qtfile(_singleton().file());
+    QFile qtfile( file );
     if ( !qtfile.open(QIODevice::ReadOnly) ) return false;
-    if ( !document.setContent( &qtfile, _singleton().error_ ) ) return false;
-    else return _read( document, _singleton().options_ );
+
+    QXmlStreamReader reader( &qtfile );
+    reader.setNamespaceProcessing( false );
+
+    if( !_read( reader, entries ) )
+    {
+        if( reader.hasError() )
+        {
+            error.error() = reader.errorString();
+            error.line() = int( reader.lineNumber() );
+            error.column() = int( reader.columnNumber() );
+        }
+
+        return false;
+    }
+
+    qtfile.close();
+    _apply( _singleton().options_, entries );
+    XmlBinaryCache::write( file, Base::Xml::Options, entries );
+
+    _singleton().setWritten();
+    return true;
 
 }
 
@@ -133,97 +347,125 @@ bool XmlOptions::write()
 {
 
     // check filename is valid
-    if( _singleton().file().isEmpty() ) return false;
+    auto& singleton( _singleton() );
+    const File& file( singleton.file() );
+    if( file.isEmpty() ) return false;
+
+    // nothing recordable changed since last read or write
+    if( !singleton.isModified() ) return true;
+
+    // generate content, keeping other sections of the existing file
+    // they are taken from the last write, unless the file was modified since, in which case the file is parsed again
+    const auto entries( optionEntries( singleton.options_ ) );
+    QByteArray content;
+    QByteArray foreign;
+    {
+        const auto stamp( fileStamp( file ) );
+        const bool useForeignSections(
+            !singleton.foreignSections_.isEmpty() &&
+            stamp.first == singleton.foreignModified_ &&
+            stamp.second == singleton.foreignSize_ );
+
+        QBuffer buffer( &singleton.foreignSections_ );
+        QFile input( file );
+        QIODevice* device( useForeignSections ? static_cast<QIODevice*>( &buffer ):static_cast<QIODevice*>( &input ) );
+        if( !( device->open( QIODevice::ReadOnly ) && writeDocument( content, foreign, entries, device ) ) )
+        {
+            content.clear();
+            foreign.clear();
+            writeDocument( content, foreign, entries, nullptr );
+        }
+    }
 
-    // create document and read
-    XmlDocument document;
+    // write to temporary file, and rename on commit
     {
-        QFile qtfile(_singleton().file());
-        if( !qtfile.open(QIODevice::ReadOnly) ) return false;
-        document.setContent( &qtfile );
+        QSaveFile output( file );
+        if( !output.open( QIODevice::WriteOnly ) ) return false;
+        if( output.write( content ) != content.size() ) return false;
+        if( !output.commit() ) return false;
     }
 
-    // read old options from xml document
-    Options options;
-    _read( document, options );
-    if( !_singleton().differs( options ) ) return true;
+    // make sure file is hidden (windows only)
+    if( file.localName().startsWith( '.' ) ) file.setHidden();
+
+    // store other sections, together with the file stamp they match
+    const auto stamp( fileStamp( file ) );
+    singleton.foreignSections_ = foreign;
+    singleton.foreignModified_ = stamp.first;
+    singleton.foreignSize_ = stamp.second;
+
+    XmlBinaryCache::write( file, Base::Xml::Options, entries );
+    singleton.setWritten();
+    return true;
+
+}
 
-    // create main element
-    auto top = document.createElement( Base::Xml::Options ).toElement();
+//________________________________________________
+bool XmlOptions::_read( QXmlStreamReader& reader, XmlBinaryCache::OptionEntry::List& entries )
+{
 
-    // write options
-    for( auto&& iter = _singleton().options_.specialOptions().begin(); iter != _singleton().options_.specialOptions().end(); ++iter )
+    // look for relevant element
+    while( !reader.atEnd() )
     {
 
-        for( const auto& option:iter.value() )
+        if( reader.readNext() != QXmlStreamReader::StartElement || reader.name() != Base::Xml::Options ) continue;
+
+        // entries are stored in file order
+        while( reader.readNextStartElement() )
         {
 
-            if( option.hasFlag( Option::Flag::Recordable ) && option.isSet() )
-            { top.appendChild( XmlOption( iter.key(), option ).domElement( document.get() ) ); }
+            const auto name( reader.name() );
+            if( name == Base::Xml::SpecialOption )
+            {
 
-        }
+                // retrieve Value attribute
+                const auto value( reader.attributes().value( Base::Xml::Value ).toString() );
+                if( value.size() )
+                {
+                    XmlBinaryCache::OptionEntry entry;
+                    entry.keep = true;
+                    entry.option.setName( value );
+                    entries.append( entry );
+                }
 
-    }
+                reader.skipCurrentElement();
 
-    // write standard options
-    for( auto&& iter = _singleton().options_.options().begin(); iter != _singleton().options_.options().end(); ++iter )
-    {
+            } else if( name == Base::Xml::Option ) {
 
-        if( iter.value().hasFlag( Option::Flag::Recordable ) && iter.value().isSet() && !iter.value().isDefault() )
-        { top.appendChild( XmlOption( iter.key(), iter.value() ).domElement( document.get() ) ); }
+                XmlBinaryCache::OptionEntry entry;
+                entry.option = XmlOption( reader );
+                entries.append( entry );
 
-    }
+            } else reader.skipCurrentElement();
 
-    // append topNode to document and write
-    document.replaceChild( top );
+        }
+
+        return !reader.hasError();
 
-    // write
-    {
-        QFile qfile( _singleton().file() );
-        if( !qfile.open( QIODevice::WriteOnly ) ) return false;
-        qfile.write( document.toByteArray() );
     }
 
-    return true;
+    return false;
 
 }
 
 //________________________________________________
-bool XmlOptions::_read( const XmlDocument& document, Options& options )
+void XmlOptions::_apply( Options& options, const XmlBinaryCache::OptionEntry::List& entries )
 {
 
-    // look for relevant element
-    auto topNodes = document.elementsByTagName( Base::Xml::Options );
-    if( topNodes.isEmpty() ) return false;
-
-    for(auto node = topNodes.at(0).firstChild(); !node.isNull(); node = node.nextSibling() )
+    for( const auto& entry:entries )
     {
-        auto element = node.toElement();
-        if( element.isNull() ) continue;
 
-        // special options
-        if( element.tagName() == Base::Xml::SpecialOption )
+        const auto& option( entry.option );
+        if( entry.keep ) options.keep( option.name() );
+        else if( options.isSpecialOption( option.name() ) )
         {
 
-            // retrieve Value attribute
-            auto value( element.attribute( Base::Xml::Value ) );
-            if( value.size() ) options.keep( value );
-
-        } else if( element.tagName() == Base::Xml::Option ) {
-
-            XmlOption option( element );
-            if( options.isSpecialOption( option.name() ) )
-            {
-
-                static const QRegularExpression invalidOptionRegExp( QStringLiteral("\\(0b\\d+\\)$") );
-                if( !invalidOptionRegExp.match( option.raw() ).hasMatch() )
-                { options.add( option.name(), (Option) option ); }
+            static const QRegularExpression invalidOptionRegExp( QStringLiteral("\\(0b\\d+\\)$") );
+            if( !invalidOptionRegExp.match( option.raw() ).hasMatch() )
+            { options.add( option.name(), (Option) option ); }
 
-            } else options.set( option.name(), (Option) option );
+        } else options.set( option.name(), (Option) option );
 
-        }
     }
 
-    return true;
-
 }
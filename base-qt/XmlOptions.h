@@ -22,10 +22,11 @@
 
 #include "File.h"
 #include "Options.h"
+#include "XmlBinaryCache.h"
 #include "base_qt_export.h"
 
 //* forward declaration
-class XmlDocument;
+class QXmlStreamReader;
 class XmlError;
 
 namespace Private
@@ -73,8 +74,11 @@ class BASE_QT_EXPORT XmlOptions
 
     protected:
 
-    //* read
-    static bool _read( const XmlDocument&, Options& );
+    //* read option entries while parsing
+    static bool _read( QXmlStreamReader&, XmlBinaryCache::OptionEntry::List& );
+
+    //* apply option entries
+    static void _apply( Options&, const XmlBinaryCache::OptionEntry::List& );
 
     private:
 
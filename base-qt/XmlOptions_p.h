@@ -24,6 +24,8 @@
 #include "Options.h"
 #include "XmlError.h"
 
+#include <QByteArray>
+
 namespace Private
 {
 
@@ -45,6 +47,8 @@ namespace Private
         {
             if( file_ == file ) return false;
             file_ = file;
+            hasWritten_ = false;
+            clearForeignSections();
             return true;
         }
 
@@ -53,9 +57,41 @@ namespace Private
         bool differs( const Options& other ) const
         { return _differs( options_, other ) || _differs( other, options_ ); }
 
+        //* true if options have recordable changes since last read or write
+        bool isModified();
+
+        //* store current options as matching file content
+        void setWritten()
+        {
+            written_ = options_;
+            writtenRevision_ = options_.revision();
+            hasWritten_ = true;
+        }
+
+        //* clear sections of the file other than options
+        void clearForeignSections()
+        {
+            foreignSections_.clear();
+            foreignModified_ = -1;
+            foreignSize_ = -1;
+        }
+
         //* options
         Options options_;
 
+        //* sections of the file other than options, as of last write
+        /**
+        they are stored as a standalone document, in which an empty options element marks where options go,
+        so that they are not parsed again from file as long as the file is not modified by others
+        */
+        QByteArray foreignSections_;
+
+        //* file modification time matching foreign sections (ms)
+        qint64 foreignModified_ = -1;
+
+        //* file size matching foreign sections
+        qint64 foreignSize_ = -1;
+
         //* error
         XmlError error_;
 
@@ -67,6 +103,15 @@ namespace Private
         //* file
         File file_;
 
+        //* options matching file content
+        Options written_;
+
+        //* options revision matching file content
+        quint64 writtenRevision_ = 0;
+
+        //* true if written_ matches file content
+        bool hasWritten_ = false;
+
     };
 
 }
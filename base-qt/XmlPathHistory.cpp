@@ -21,6 +21,7 @@
 #include "Debug.h"
 #include "Operators.h"
 #include "Singleton.h"
+#include "XmlBinaryCache.h"
 #include "XmlDocument.h"
 #include "XmlFileRecord.h"
 #include "XmlOptions.h"
@@ -73,22 +74,20 @@ bool XmlPathHistory::read( File file )
     if( file.isEmpty() ) file = dbFile_;
     if( file.isEmpty() || !file.exists() ) return false;
 
-    // parse the file
-    XmlDocument document;
-    QFile qfile( file );
-    if( !qfile.open( QIODevice::ReadOnly ) ) return false;
-
-    if ( !document.setContent( &qfile ) )
+    // try binary cache, then parse the file
+    FileRecord::List pathList;
+    if( !XmlBinaryCache::read( file, tagName_, pathList ) )
     {
+        QFile qfile( file );
+        if( !qfile.open( QIODevice::ReadOnly ) ) return false;
+        if( !XmlFileRecord::Helper::read( &qfile, tagName_, pathList ) ) return false;
+        qfile.close();
+        XmlBinaryCache::write( file, tagName_, pathList );
+    }
 
-        Debug::Throw() << document.error() << Qt::endl;
-        return false;
-
-    } else if( _read( document ) ) {
-
-        return true;
-
-    } else return false;
+    // assign
+    setPathList( pathList );
+    return true;
 
 }
 
@@ -161,11 +160,15 @@ bool XmlPathHistory::write( File file )
 
     // create main element and insert
     auto top = document.createElement( tagName_ );
+    FileRecord::List written;
     for( const auto& path:pathList )
     {
 
         if( !path.file().isEmpty() )
-        { top.appendChild( XmlFileRecord( path ).domElement( document.get() ) ); }
+        {
+            top.appendChild( XmlFileRecord( path ).domElement( document.get() ) );
+            written.append( path );
+        }
 
     }
 
@@ -177,6 +180,7 @@ bool XmlPathHistory::write( File file )
         qfile.write( document.toByteArray() );
     }
 
+    XmlBinaryCache::write( file, tagName_, written );
     return true;
 }
 
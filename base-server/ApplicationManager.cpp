@@ -21,12 +21,14 @@
 #include "Client.h"
 #include "CppUtil.h"
 #include "Debug.h"
+#include "StartupProfiler.h"
 #include "Util.h"
 #include "XmlOptions.h"
 
 
 #include <QCoreApplication>
-#include <algorithm>
+#include <QDir>
+#include <QStandardPaths>
 
 namespace Server
 {
@@ -74,6 +76,7 @@ namespace Server
     {
 
         Debug::Throw( QStringLiteral("ApplicationManager::init.\n") );
+        StartupProfiler::Scope scope( "ApplicationManager::initialize" );
 
         // store arguments
         arguments_ = arguments;
@@ -97,7 +100,18 @@ namespace Server
 
         } else port_ = XmlOptions::get().get<int>( QStringLiteral("SERVER_PORT") );
 
+        // local transport is used when the server runs on this machine
+        #if defined(Q_OS_UNIX)
+        transport_ = host_.isLoopback() ? Client::Transport::Local : Client::Transport::Tcp;
+        #endif
+
         Debug::Throw() << "ApplicationManager::initialize - port: " << port_ << Qt::endl;
+
+        /*
+        with local transport, the server instance is elected using a lock file,
+        so that detecting an existing instance needs no connection attempt
+        */
+        if( transport_ == Client::Transport::Local && !serverInitialized_ ) _initializeServer();
         _initializeClient();
 
         Debug::Throw( QStringLiteral("ApplicationManager::init. done.\n") );
@@ -129,6 +143,16 @@ namespace Server
             if( state_ == State::AwaitingReply && setState( State::Alive ) )
             { emit commandRecieved( ServerCommand( id_, ServerCommand::CommandType::Accepted ) ); }
 
+        } else if( event->timerId() == retryTimer_.timerId() ) {
+
+            Debug::Throw( QStringLiteral("ApplicationManager::timerEvent - retry.\n") );
+            retryTimer_.stop();
+            if( state_ == State::Dead ) return;
+
+            // the lock is taken again, in case its owner has exited in the meantime
+            _initializeServer();
+            _initializeClient();
+
         }
 
         return QObject::timerEvent( event );
@@ -140,15 +164,32 @@ namespace Server
     {
         Debug::Throw( QStringLiteral("ApplicationManager::_register.\n") );
 
-        if( forced ) return acceptedClients_.insert( id, client );
-        else {
+        auto iter = acceptedClients_.find( id );
+        if( forced )
+        {
 
-            auto iter = acceptedClients_.find( id );
-            if( iter == acceptedClients_.end() ) iter = std::find( acceptedClients_.begin(), acceptedClients_.end(), client );
-            if( iter == acceptedClients_.end() ) return acceptedClients_.insert( id, client );
-            else return iter;
+            // replace existing client, if any
+            if( iter != acceptedClients_.end() ) acceptedIds_.remove( iter.value()->id(), id );
+            acceptedIds_.insert( client->id(), id );
+            return acceptedClients_.insert( id, client );
 
         }
+
+        // look for application id already registered by this client
+        if( iter == acceptedClients_.end() )
+        {
+            const auto idIter( acceptedIds_.constFind( client->id() ) );
+            if( idIter != acceptedIds_.constEnd() ) iter = acceptedClients_.find( idIter.value() );
+        }
+
+        if( iter == acceptedClients_.end() )
+        {
+            acceptedIds_.insert( client->id(), id );
+            return acceptedClients_.insert( id, client );
+        }
+
+        return iter;
+
     }
 
     //_____________________________________________________
@@ -169,6 +210,7 @@ namespace Server
 
                 // unlock request. Clear list of registered applications
                 acceptedClients_.clear();
+                acceptedIds_.clear();
                 return;
 
             }
@@ -283,8 +325,10 @@ namespace Server
     {
 
         Debug::Throw() << "ApplicationManager::_Broadcast - id: " << command.id().name() << " command: " << command.commandName() << Qt::endl;
+        // command is encoded once, and the frame shared by all recipients
+        const auto frame( Client::frame( command ) );
         for( auto& client:connectedClients_ )
-        { if( client != sender ) client->sendCommand( command ); }
+        { if( client != sender ) client->sendFrame( frame ); }
 
     }
 
@@ -292,15 +336,28 @@ namespace Server
     void ApplicationManager::_newConnection()
     {
         Debug::Throw( QStringLiteral("ApplicationManager::_newConnection.\n") );
-        while( server_->hasPendingConnections() )
+        // create clients from pending connections
+        if( server_ )
         {
-            // create client from pending connection
-            auto client = std::make_shared<Client>( this, server_->nextPendingConnection() );
-            connect( client.get(), &Client::commandAvailable, this, QOverload<const Server::ServerCommand&>::of( &ApplicationManager::_redirect ) );
-            connect( &client->socket(), &QAbstractSocket::disconnected, this, &ApplicationManager::_clientConnectionClosed );
-            connectedClients_.append( client );
+            while( server_->hasPendingConnections() )
+            { _addClient( std::make_shared<Client>( this, server_->nextPendingConnection() ) ); }
         }
 
+        if( localServer_ )
+        {
+            while( localServer_->hasPendingConnections() )
+            { _addClient( std::make_shared<Client>( this, localServer_->nextPendingConnection() ) ); }
+        }
+
+    }
+
+    //_____________________________________________________
+    void ApplicationManager::_addClient( ClientPtr client )
+    {
+        connect( client.get(), &Client::commandAvailable, this, QOverload<const Server::ServerCommand&>::of( &ApplicationManager::_redirect ) );
+        const quint32 id( client->id() );
+        connect( client.get(), &BaseSocketInterface::disconnected, this, [this, id]() { _clientConnectionClosed( id ); } );
+        connectedClients_.insert( id, client );
     }
 
     //_____________________________________________________
@@ -312,28 +369,27 @@ namespace Server
     }
 
     //_____________________________________________________
-    void ApplicationManager::_clientConnectionClosed()
+    void ApplicationManager::_clientConnectionClosed( quint32 clientId )
     {
 
         Debug::Throw( QStringLiteral("ApplicationManager::_clientConnectionClosed - client has disconnected.\n") );
 
-        // look for disconnected clients in client map
-        for( auto&& iter = acceptedClients_.begin(); iter != acceptedClients_.end(); )
-        {
-            if( iter.value()->socket().state() == QAbstractSocket::UnconnectedState )
-            {
+        // remove from connected clients
+        const auto iter( connectedClients_.find( clientId ) );
+        if( iter == connectedClients_.end() ) return;
+        const auto client( iter.value() );
+        connectedClients_.erase( iter );
 
-                // broadcast client as dead and erase from list
-                _broadcast( ServerCommand( iter.key(), ServerCommand::CommandType::Killed ), iter.value() );
-                iter = acceptedClients_.erase( iter );
-
-            } else ++iter;
+        // broadcast registered applications as dead and remove from accepted clients
+        for( const auto& id:acceptedIds_.values( clientId ) )
+        {
+            const auto acceptedIter( acceptedClients_.find( id ) );
+            if( acceptedIter == acceptedClients_.end() || acceptedIter.value() != client ) continue;
+            _broadcast( ServerCommand( acceptedIter.key(), ServerCommand::CommandType::Killed ), client );
+            acceptedClients_.erase( acceptedIter );
         }
 
-        // remove disconnected clients from connected clients list
-        connectedClients_.erase( std::remove_if( connectedClients_.begin(), connectedClients_.end(), SameStateFTor( QAbstractSocket::UnconnectedState ) ), connectedClients_.end() );
-
-        return;
+        acceptedIds_.remove( clientId );
 
     }
 
@@ -341,7 +397,7 @@ namespace Server
     void ApplicationManager::_error( QAbstractSocket::SocketError error )
     {
 
-        Debug::Throw() << "ApplicationManager::_error - error:" << client_->socket().errorString() << Qt::endl;
+        Debug::Throw() << "ApplicationManager::_error - error:" << client_->errorString() << Qt::endl;
 
         if( error == QAbstractSocket::ConnectionRefusedError )
         {
@@ -358,6 +414,11 @@ namespace Server
                 _initializeServer();
                 _initializeClient();
 
+            } else if( transport_ == Client::Transport::Local && !( lockFile_ && lockFile_->isLocked() ) ) {
+
+                // another instance owns the lock, but is not listening yet
+                _retryConnection();
+
             } else if( setState( State::Alive  ) ) {
 
                 emit commandRecieved( ServerCommand( id_, ServerCommand::CommandType::Accepted ) );
@@ -365,7 +426,7 @@ namespace Server
             }
 
         } else {
-            Debug::Throw() << "ApplicationManager::_error - unhandled error:" << client_->socket().errorString() << Qt::endl;
+            Debug::Throw() << "ApplicationManager::_error - unhandled error:" << client_->errorString() << Qt::endl;
         }
 
         return;
@@ -377,8 +438,14 @@ namespace Server
 
         Debug::Throw( QStringLiteral("Application::_redirect.\n") );
 
-        _redirect( command, *std::find_if(  connectedClients_.begin(), connectedClients_.end(), Client::SameIdFTor( command.clientId() ) ) );
-        return;
+        const auto iter( connectedClients_.constFind( command.clientId() ) );
+        if( iter == connectedClients_.constEnd() )
+        {
+            Debug::Throw(0) << "ApplicationManager::_redirect - unknown client: " << command.clientId() << Qt::endl;
+            return;
+        }
+
+        _redirect( command, iter.value() );
     }
 
 
@@ -455,6 +522,30 @@ namespace Server
 
         serverInitialized_ = true;
 
+        if( transport_ == Client::Transport::Local )
+        {
+
+            // only the lock owner listens. The lock is kept for the lifetime of the application
+            if( !lockFile_ ) lockFile_.reset( new ServerLockFile( _localServerName() + QStringLiteral(".lock") ) );
+            if( !lockFile_->tryLock() ) return false;
+
+            // existing socket, if any, was left by a previous lock owner
+            const auto name( _localServerName() );
+            QLocalServer::removeServer( name );
+
+            localServer_.reset( new QLocalServer( this ) );
+            localServer_->setSocketOptions( QLocalServer::UserAccessOption );
+            connect( localServer_.get(), &QLocalServer::newConnection, this, &ApplicationManager::_newConnection );
+            if( localServer_->listen( name ) ) return true;
+
+            // release the lock, so that other instances do not wait for a server that never listens
+            Debug::Throw(0) << "ApplicationManager::_initializeServer - unable to listen on " << name << ": " << localServer_->errorString() << Qt::endl;
+            localServer_.reset();
+            lockFile_->unlock();
+            return false;
+
+        }
+
         server_.reset( new QTcpServer( this ) );
         connect( server_.get(), &QTcpServer::newConnection, this, &ApplicationManager::_newConnection );
 
@@ -462,19 +553,51 @@ namespace Server
 
     }
 
+    //__________________________________________________________________________
+    void ApplicationManager::_retryConnection()
+    {
+
+        // maximum number of retries, and maximum delay between retries (ms)
+        static const int maxRetryCount = 10;
+        static const int maxDelay = 1000;
+
+        // the lock owner never listened. Run standalone, as when no server is found
+        if( retryCount_ >= maxRetryCount )
+        {
+            Debug::Throw(0) << "ApplicationManager::_retryConnection - unable to connect to server instance " << _localServerName() << ". Running standalone." << Qt::endl;
+            if( setState( State::Alive ) ) emit commandRecieved( ServerCommand( id_, ServerCommand::CommandType::Accepted ) );
+            return;
+        }
+
+        const int delay( qMin( 50<<retryCount_, maxDelay ) );
+        Debug::Throw() << "ApplicationManager::_retryConnection - retry " << retryCount_ << " in " << delay << "ms" << Qt::endl;
+        ++retryCount_;
+        retryTimer_.start( delay, this );
+
+    }
+
+    //__________________________________________________________________________
+    QString ApplicationManager::_localServerName() const
+    {
+        auto path( QStandardPaths::writableLocation( QStandardPaths::RuntimeLocation ) );
+        if( path.isEmpty() ) path = QDir::tempPath();
+        return QStringLiteral( "%1/base-server-%2" ).arg( path ).arg( port_ );
+    }
+
     //__________________________________________________________________________
     bool ApplicationManager::_initializeClient()
     {
 
         Debug::Throw() << "ApplicationManager::_initializeClient - connecting to host: " << host_.toString() << " port: " << port_ << Qt::endl;
 
-        // connect client to port
-        client_.reset( new Client( this ) );
-        connect( &client_->socket(), QOverload<QAbstractSocket::SocketError>::of( &QAbstractSocket::errorOccurred ), this, &ApplicationManager::_error );
-        connect( &client_->socket(), &QAbstractSocket::connected, this, &ApplicationManager::_startTimer );
-        connect( &client_->socket(), &QAbstractSocket::disconnected, this, &ApplicationManager::_serverConnectionClosed );
+        // connect client to server
+        client_.reset( new Client( this, transport_ ) );
+        connect( client_.get(), &BaseSocketInterface::errorOccurred, this, &ApplicationManager::_error );
+        connect( client_.get(), &BaseSocketInterface::connected, this, &ApplicationManager::_startTimer );
+        connect( client_.get(), &BaseSocketInterface::disconnected, this, &ApplicationManager::_serverConnectionClosed );
         connect( client_.get(), &Client::commandAvailable, this, &ApplicationManager::_process );
-        client_->socket().connectToHost( host_, port_ );
+        if( transport_ == Client::Transport::Local ) client_->connectToServer( _localServerName() );
+        else client_->connectToHost( host_, port_ );
 
         // emit initialization signal
         emit initialized();
@@ -496,6 +619,8 @@ namespace Server
     //__________________________________________________________________________
     void ApplicationManager::_startTimer()
     {
+        retryCount_ = 0;
+
         // time out delay (for existing server to reply)
         // one should really start the timer only when the client is connected
         int timeoutDelay( XmlOptions::get().contains( QStringLiteral("SERVER_TIMEOUT_DELAY") ) ? XmlOptions::get().get<int>( QStringLiteral("SERVER_TIMEOUT_DELAY") ) : 2000 );
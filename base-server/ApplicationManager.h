@@ -26,14 +26,16 @@
 #include "Counter.h"
 #include "ObjectDeleter.h"
 #include "ServerCommand.h"
+#include "ServerLockFile.h"
 #include "base_server_export.h"
 
 #include <QBasicTimer>
 #include <QHash>
 #include <QHostAddress>
 #include <QList>
+#include <QLocalServer>
+#include <QMultiHash>
 #include <QObject>
-#include <QPair>
 #include <QTcpServer>
 #include <QTimerEvent>
 
@@ -124,8 +126,8 @@ namespace Server
         //* a connection was closed
         void _serverConnectionClosed();
 
-        //* a connection was closed
-        void _clientConnectionClosed();
+        //* connection to a given client was closed
+        void _clientConnectionClosed( quint32 );
 
         //* client recieves errors
         void _error( QAbstractSocket::SocketError );
@@ -142,34 +144,14 @@ namespace Server
         //* client pointer
         using ClientPtr = std::shared_ptr<Client>;
 
-        //* pair of application id and client
-        using ClientPair = QPair<ApplicationId, ClientPtr>;
-
-        //* map of clients
+        //* map of clients, indexed by application id
         using ClientMap = QHash<ApplicationId, ClientPtr>;
 
-        //* list of clients
-        using ClientList = QList<ClientPtr>;
-
-        //* used to retrieve clients for a given state
-        class BASE_SERVER_EXPORT SameStateFTor: public Client::SameStateFTor
-        {
-            public:
-
-            //* constructor
-            template<class T>
-            explicit SameStateFTor( const T& state ):
-                Client::SameStateFTor( state )
-            {}
+        //* map of clients, indexed by client id
+        using ClientIdMap = QHash<quint32, ClientPtr>;
 
-            //* parent class operator
-            using Client::SameStateFTor::operator();
-
-            //* predicate
-            bool operator() ( const ClientPair& pair ) const
-            { return Client::SameStateFTor::operator() (pair.second); }
-
-        };
+        //* application ids registered by a given client, indexed by client id
+        using ApplicationIdMap = QMultiHash<quint32, ApplicationId>;
 
         /** \brief register a client, returns true if application is new.
         if forced is set to true, the old cliend, if any, is replaced
@@ -182,36 +164,64 @@ namespace Server
         //* broadcast a message to all registered clients but the sender (if valid)
         void _broadcast( const ServerCommand&, ClientPtr sender = ClientPtr() );
 
+        //* add client for accepted connection
+        void _addClient( ClientPtr );
+
+        //* local server name, also used for the lock file
+        QString _localServerName() const;
+
         //* initialize client
         bool _initializeClient();
 
         //* initialize server
         bool _initializeServer();
 
+        //* retry connecting to a server instance that is not listening yet. Runs standalone once retries are exhausted
+        void _retryConnection();
+
         //* host
         QHostAddress host_ = QHostAddress::LocalHost;
 
         //* port
         int port_ = 8091;
 
+        //* transport
+        Client::Transport transport_ = Client::Transport::Tcp;
+
         //* arguments
         CommandLineArguments arguments_;
 
         //* Server
         std::unique_ptr<QTcpServer, Base::ObjectDeleter> server_;
 
+        //* local server
+        std::unique_ptr<QLocalServer, Base::ObjectDeleter> localServer_;
+
+        //* lock file, owned by the server instance
+        std::unique_ptr<ServerLockFile> lockFile_;
+
         //* true if initializeServer was called
         bool serverInitialized_ = false;
 
+        //* connection retry timer, when the lock is owned by another instance
+        QBasicTimer retryTimer_;
+
+        //* number of connection retries
+        int retryCount_ = 0;
+
         //* Client
         std::unique_ptr<Client, Base::ObjectDeleter> client_;
 
-        //* list of connected clients
-        ClientList connectedClients_;
+        //* connected clients
+        /** clients are added when accepted by the server and removed when their socket emits disconnected */
+        ClientIdMap connectedClients_;
 
-        //* maps accepted clients and amount of request
+        //* accepted clients
         ClientMap acceptedClients_;
 
+        //* application ids registered in acceptedClients_, for each client
+        ApplicationIdMap acceptedIds_;
+
         //* application name
         ApplicationId id_;
 
@@ -19,15 +19,13 @@
 
 #include "BaseApplication.h"
 #include "BaseIconNames.h"
-#include "Command.h"
 #include "CppUtil.h"
-#include "CustomProcess.h"
-#include "File.h"
 #include "IconEngine.h"
 #include "IconSize.h"
 #include "QtUtil.h"
 #include "ServerSystemOptions.h"
-#include "Util.h"
+#include "StartupProfiler.h"
+#include "SystemFontThread.h"
 #include "XmlOptions.h"
 
 #include <QApplication>
@@ -36,8 +34,6 @@
 #include <QLabel>
 #include <QMessageBox>
 
-#include <QSettings>
-
 //____________________________________________
 namespace Server
 {
@@ -124,6 +120,10 @@ bool BaseApplication::realizeWidget()
 
     // check if the method has already been called.
     if( !BaseCoreApplication::realizeWidget() ) return false;
+    StartupProfiler::Scope scope( "BaseApplication::realizeWidget" );
+
+    // record first paint
+    if( StartupProfiler::isEnabled() ) qApp->installEventFilter( this );
 
     // always enable high dpi
     qApp->setAttribute( Qt::AA_UseHighDpiPixmaps, true );
@@ -145,6 +145,7 @@ bool BaseApplication::realizeWidget()
     configurationAction_ = new QAction( IconEngine::get( IconNames::Configure ), tr( "Configure %1..." ).arg( applicationName() ), this );
     connect( configurationAction_, &QAction::triggered, this, &BaseApplication::_configuration );
 
+    _startupStage( QStringLiteral("icon theme and actions") );
     return true;
 }
 
@@ -171,6 +172,21 @@ CommandLineParser BaseApplication::commandLineParser( const CommandLineArguments
 
 }
 
+//____________________________________________
+bool BaseApplication::eventFilter( QObject* object, QEvent* event )
+{
+    if( event->type() == QEvent::Paint && object->isWidgetType() )
+    {
+        qApp->removeEventFilter( this );
+        StartupProfiler::addMark( QStringLiteral("first paint") );
+        _startupStage( QStringLiteral("first paint") );
+        if( !StartupProfiler::finish() )
+        { Debug::Throw(0) << "BaseApplication::eventFilter - unable to write startup trace to " << StartupProfiler::fileName() << Qt::endl; }
+    }
+
+    return BaseCoreApplication::eventFilter( object, event );
+}
+
 //____________________________________________
 void BaseApplication::busy()
 { qApp->setOverrideCursor( Qt::WaitCursor ); }
@@ -258,6 +274,7 @@ void BaseApplication::_updateFonts()
 {
 
     Debug::Throw( QStringLiteral("BaseApplication::_updateFonts.\n") );
+    StartupProfiler::Scope scope( "BaseApplication::_updateFonts" );
 
     // default widget font
     if( !XmlOptions::get().get<bool>( QStringLiteral("USE_SYSTEM_FONT") ) )
@@ -276,84 +293,78 @@ void BaseApplication::_updateFonts()
 
     } else {
 
-        File::List configurationFiles;
-        if( XmlOptions::get().contains( QStringLiteral("KDE_CONFIG") ) )
-        {
+        const QString command( XmlOptions::get().contains( QStringLiteral("KDE_CONFIG") ) ? XmlOptions::get().raw( QStringLiteral("KDE_CONFIG") ):QString() );
 
-            // get kde4 config command and retrieve output
-            const QString kde4ConfigCommand( XmlOptions::get().raw( QStringLiteral("KDE_CONFIG") ) );
+        // use fonts from previous discovery, or from startup cache, as long as kde configuration files are unchanged
+        if( !( systemFonts_.isValid() && systemFonts_.command() == command && systemFonts_.isUpToDate() ) )
+        { systemFonts_ = SystemFonts::read( command ); }
 
-            CustomProcess process( this );
-            process.start( Base::Command( kde4ConfigCommand ) << "--path" << "config" );
-            if( process.waitForFinished() && process.exitStatus() == QProcess::NormalExit )
-            {
-                auto configurationPath = QString( process.readAllStandardOutput() ).trimmed().split( QLatin1Char(':') );
-                std::transform( configurationPath.begin(), configurationPath.end(), std::back_inserter( configurationFiles ),
-                    []( const QString& path ) { return File( "kdeglobals" ).addPath( File( path ) ); } );
-            }
+        if( systemFonts_.isValid() )
+        {
 
-        }
+            _applySystemFonts( systemFonts_ );
+            if( !fontsInitialized_ ) _startupStage( QStringLiteral("system fonts (cached)") );
+            fontsInitialized_ = true;
+            return;
 
-        if( configurationFiles.isEmpty() )
-        {
-            // add some files manually in case the above failed
-            configurationFiles.append( File( ".config/kdeglobals" ).addPath( Util::home() ) );
-            configurationFiles.append( File( ".kde/share/config/kdeglobals" ).addPath( Util::home() ) );
-            configurationFiles.append( File( ".kde4/share/config/kdeglobals" ).addPath( Util::home() ) );
         }
 
-        bool fontFound( false );
-        bool fixedFontFound( !useFixedFonts() );
-        for( const auto& file:configurationFiles )
+        // discover fonts in the background. Default fonts are used in the meantime
+        if( !systemFontThread_ )
         {
+            systemFontThread_ = new SystemFontThread( this );
+            connect( systemFontThread_, &SystemFontThread::fontsAvailable, this, [this]( const SystemFonts& fonts )
+            {
+                systemFonts_ = fonts;
+                _applySystemFonts( fonts );
+                if( !fontsInitialized_ ) _startupStage( QStringLiteral("system fonts (discovered)") );
+                fontsInitialized_ = true;
+            } );
+        }
 
-            // check file existence
-            if( !file.exists() ) continue;
+        systemFontThread_->discover( command );
 
-            Debug::Throw() << "BaseApplication::_updateFonts - file: " << file << Qt::endl;
+    }
 
-            // load settings
-            QSettings settings( file, QSettings::IniFormat );
-            settings.sync();
+}
 
-            // generic font
-            if( !fontFound && settings.contains( QStringLiteral("font") ) )
-            {
-                auto fontName( settings.value( QStringLiteral("font") ).toStringList().join( QStringLiteral(",") ) );
-                QFont font;
-                font.fromString( fontName );
-                qApp->setFont( font );
-                qApp->setFont( font, "QTextEdit" );
-                qApp->setFont( font, "QPlainTextEdit" );
-                fontFound = true;
-                Debug::Throw() << "BaseApplication::_updateFonts - font: " << fontName << Qt::endl;
-            }
+//_______________________________________________
+void BaseApplication::_applySystemFonts( const SystemFonts& fonts )
+{
 
-            // fixed fonts
-            if( useFixedFonts() && !fixedFontFound && settings.contains( QStringLiteral("fixed") ))
-            {
-                auto fixedFontName( settings.value( QStringLiteral("fixed") ).toStringList().join( QStringLiteral(",") ) );
-                QFont font;
-                font.fromString( fixedFontName );
-                fixedFontFound = true;
-                Debug::Throw() << "BaseApplication::_updateFonts - fixed: " << fixedFontName << Qt::endl;
-                qApp->setFont( font, "QTextEdit" );
-                qApp->setFont( font, "QPlainTextEdit" );
-            }
+    Debug::Throw( QStringLiteral("BaseApplication::_applySystemFonts.\n") );
 
-            if( fontFound && fixedFontFound ) break;
+    // check that system fonts are still in use, and match current kde configuration command
+    if( !XmlOptions::get().get<bool>( QStringLiteral("USE_SYSTEM_FONT") ) ) return;
+    const QString command( XmlOptions::get().contains( QStringLiteral("KDE_CONFIG") ) ? XmlOptions::get().raw( QStringLiteral("KDE_CONFIG") ):QString() );
+    if( fonts.command() != command ) return;
 
-        }
+    const bool fontFound( !fonts.font().isEmpty() );
+    const bool fixedFontFound( !useFixedFonts() || !fonts.fixedFont().isEmpty() );
+    if( !( fontFound && fixedFontFound ) )
+    {
+        qApp->setFont( QFont() );
+        qApp->setFont( QFont(), "QTextEdit" );
+        qApp->setFont( QFont(), "QPlainTextEdit" );
+        return;
+    }
 
-        if( !( fontFound && fixedFontFound ) )
-        {
-            qApp->setFont( QFont() );
-            qApp->setFont( QFont(), "QTextEdit" );
-            qApp->setFont( QFont(), "QPlainTextEdit" );
-        }
+    // generic font
+    Debug::Throw() << "BaseApplication::_applySystemFonts - font: " << fonts.font() << Qt::endl;
+    QFont font;
+    font.fromString( fonts.font() );
+    qApp->setFont( font );
 
+    // fixed fonts
+    if( useFixedFonts() )
+    {
+        Debug::Throw() << "BaseApplication::_applySystemFonts - fixed: " << fonts.fixedFont() << Qt::endl;
+        font.fromString( fonts.fixedFont() );
     }
 
+    qApp->setFont( font, "QTextEdit" );
+    qApp->setFont( font, "QPlainTextEdit" );
+
 }
 
 //_______________________________________________
@@ -361,6 +372,7 @@ void BaseApplication::_updateIconTheme()
 {
 
     Debug::Throw( QStringLiteral("BaseApplication::_updateIconTheme.\n") );
+    StartupProfiler::Scope scope( "BaseApplication::_updateIconTheme" );
     if( XmlOptions::get().get<bool>( QStringLiteral("USE_ICON_THEME") ) )
     {
         QIcon::setThemeSearchPaths( { XmlOptions::get().raw( QStringLiteral("ICON_THEME_PATH") ) } );
@@ -23,11 +23,14 @@
 #include "ApplicationManager.h"
 #include "BaseCoreApplication.h"
 #include "CommandLineArguments.h"
+#include "SystemFonts.h"
 #include "base_server_export.h"
 
 #include <QAction>
 #include <QObject>
 
+class SystemFontThread;
+
 //* Main Window singleton object
 class BASE_SERVER_EXPORT BaseApplication: public BaseCoreApplication
 {
@@ -96,6 +99,9 @@ class BASE_SERVER_EXPORT BaseApplication: public BaseCoreApplication
     //* set application idle
     void idle();
 
+    //* event filter, used to record first paint when profiling startup
+    bool eventFilter( QObject*, QEvent* ) override;
+
     protected:
 
     //* process request from application manager
@@ -112,6 +118,9 @@ class BASE_SERVER_EXPORT BaseApplication: public BaseCoreApplication
     //* fonts
     void _updateFonts();
 
+    //* apply system fonts
+    void _applySystemFonts( const SystemFonts& );
+
     //* update icon path
     void _updateIconTheme();
 
@@ -121,6 +130,15 @@ class BASE_SERVER_EXPORT BaseApplication: public BaseCoreApplication
     //* true if fixed fonts are used
     bool useFixedFonts_ = false;
 
+    //* true once fonts have been set at startup
+    bool fontsInitialized_ = false;
+
+    //* system fonts
+    SystemFonts systemFonts_;
+
+    //* system font discovery thread
+    SystemFontThread* systemFontThread_ = nullptr;
+
     //*@name actions
     //@{
 
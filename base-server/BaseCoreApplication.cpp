@@ -21,6 +21,7 @@
 #include "Debug.h"
 #include "ErrorHandler.h"
 #include "InterruptionHandler.h"
+#include "StartupProfiler.h"
 #include "XmlOptions.h"
 
 
@@ -43,6 +44,16 @@ BaseCoreApplication::BaseCoreApplication( QObject* parent, const CommandLineArgu
     // configuration
     connect( this, &BaseCoreApplication::configurationChanged, this, &BaseCoreApplication::_updateConfiguration );
 
+    // startup profiler. When enabled from command line, phases preceding application construction are not recorded
+    const auto parser( BaseCoreApplication::commandLineParser( arguments_ ) );
+    if( parser.hasOption( QStringLiteral("--trace-startup") ) )
+    {
+        StartupProfiler::setFileName( parser.option( QStringLiteral("--trace-startup") ) );
+        StartupProfiler::setEnabled( true );
+    }
+
+    _startupStage( QStringLiteral("initialization") );
+
 }
 
 //____________________________________________
@@ -51,6 +62,7 @@ BaseCoreApplication::~BaseCoreApplication()
     Debug::Throw( QStringLiteral("BaseCoreApplication::~BaseCoreApplication.\n") );
     emit saveConfiguration();
     XmlOptions::write();
+    StartupProfiler::finish();
     ErrorHandler::get().exit();
 }
 
@@ -62,6 +74,7 @@ bool BaseCoreApplication::initApplicationManager()
 
     // check if already initialized
     if( _hasApplicationManager() ) return true;
+    StartupProfiler::Scope scope( "BaseCoreApplication::initApplicationManager" );
 
     // assign application name to qapplication
     qApp->setApplicationName( applicationName() );
@@ -83,11 +96,14 @@ bool BaseCoreApplication::initApplicationManager()
 
     } else if( parser.hasFlag( QStringLiteral("--no-server") ) ) {
 
+        _startupStage( QStringLiteral("command line") );
         realizeWidget();
         return true;
 
     }
 
+    _startupStage( QStringLiteral("command line") );
+
     // create application manager
     applicationManager_.reset( new Server::ApplicationManager( this ) );
     applicationManager_->setApplicationName( applicationName() );
@@ -97,6 +113,7 @@ bool BaseCoreApplication::initApplicationManager()
 
     // initialization
     applicationManager_->initialize( arguments_ );
+    _startupStage( QStringLiteral("application manager") );
     return true;
 
 }
@@ -109,6 +126,7 @@ bool BaseCoreApplication::realizeWidget()
     //* check if the method has already been called.
     if( realized_ ) return false;
     realized_ = true;
+    if( applicationManager_ ) _startupStage( QStringLiteral("server negotiation") );
     return true;
 
 }
@@ -124,6 +142,7 @@ CommandLineParser BaseCoreApplication::commandLineParser( const CommandLineArgum
     out.setGroup( CommandLineParser::applicationGroupName );
     out.registerFlag( CommandLineParser::Tag( QStringLiteral("--help"), QStringLiteral("-h") ), QObject::tr( "print this help and exit" ) );
     out.registerFlag( CommandLineParser::Tag( QStringLiteral("--version"), QStringLiteral("-v") ), QObject::tr( "print application version and exits" ) );
+    out.registerOption( QStringLiteral("--trace-startup"), QObject::tr( "file" ), QObject::tr( "write startup phases to file, in chrome trace event format" ) );
 
     if( !arguments.isEmpty() )
     { out.parse( arguments, ignoreWarnings ); }
@@ -185,6 +204,15 @@ void BaseCoreApplication::_updateConfiguration()
 
 }
 
+//_______________________________________________
+void BaseCoreApplication::_startupStage( const QString& name )
+{
+    const qint64 elapsed( StartupProfiler::elapsed() );
+    Debug::Throw() << "BaseCoreApplication::_startupStage - " << name << ": " << ( elapsed - startupStageTime_ )/1000 << " ms (total: " << elapsed/1000 << " ms)" << Qt::endl;
+    StartupProfiler::addStage( name, startupStageTime_, elapsed );
+    startupStageTime_ = elapsed;
+}
+
 //_______________________________________________
 void BaseCoreApplication::_usage( const QString &application, const QString &options ) const
 {
@@ -116,6 +116,9 @@ class BASE_SERVER_EXPORT BaseCoreApplication: public QObject
     Server::ApplicationManager& _applicationManager() const
     { return *applicationManager_.get(); }
 
+    //* report time spent in a given startup stage, since previous stage
+    void _startupStage( const QString& );
+
     private:
 
     //* configuration
@@ -130,6 +133,9 @@ class BASE_SERVER_EXPORT BaseCoreApplication: public QObject
     //* true when Realized Widget has been called.
     bool realized_ = false;
 
+    //* time at which previous startup stage ended, since startup profiler clock start (us)
+    qint64 startupStageTime_ = 0;
+
 };
 
 #endif
@@ -21,8 +21,6 @@
 #include "Debug.h"
 #include "TypeId.h"
 
-#include <QDataStream>
-
 template<> class Base::TypeId<Server::ServerCommand> : public Base::RegisterTypeId<Server::ServerCommand, 1> {};
 
 namespace Server
@@ -35,34 +33,48 @@ namespace Server
         return counter;
     }
 
+    //_______________________________________________________
+    Client::Client( QObject* parent, Transport transport ):
+        BaseSocketInterface( parent, transport ),
+        Counter( QStringLiteral("Server::Client") ),
+        id_( _counter()++ )
+    {}
+
     //_______________________________________________________
     Client::Client( QObject* parent, QTcpSocket* socket ):
         BaseSocketInterface( parent, socket ),
         Counter( QStringLiteral("Server::Client") ),
         id_( _counter()++ )
-    { connect( this, &BaseSocketInterface::bufferReceived, this, &Client::_parseBuffer ); }
+    {}
 
     //_______________________________________________________
-    void Client::sendCommand( const ServerCommand& command )
-    {
-        QByteArray array;
-        QDataStream stream( &array, QIODevice::WriteOnly );
-        stream << command;
-        sendBuffer( Base::TypeId<ServerCommand>::value, array );
-    }
+    Client::Client( QObject* parent, QLocalSocket* socket ):
+        BaseSocketInterface( parent, socket ),
+        Counter( QStringLiteral("Server::Client") ),
+        id_( _counter()++ )
+    {}
 
     //_______________________________________________________
-    void Client::_parseBuffer( qint32 bufferType, QByteArray buffer )
+    QByteArray Client::frame( const ServerCommand& command )
+    { return BaseSocketInterface::frame( Base::TypeId<ServerCommand>::value, command.encoded() ); }
+
+    //_______________________________________________________
+    void Client::_processBuffer( qint32 bufferType, const QByteArray& buffer )
     {
+
+        // commands are decoded in place, without copying the buffer
         if( bufferType == Base::TypeId<ServerCommand>::value )
         {
             ServerCommand command;
-            QDataStream stream( &buffer, QIODevice::ReadOnly );
-            stream >> command;
-            command.setClientId( id() );
-            emit commandAvailable( command );
+            if( ServerCommand::decode( buffer, command ) )
+            {
+                command.setClientId( id() );
+                emit commandAvailable( command );
+            }
         }
 
+        BaseSocketInterface::_processBuffer( bufferType, buffer );
+
     }
 
 }
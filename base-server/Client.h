@@ -26,6 +26,7 @@
 #include "ServerCommand.h"
 #include "base_server_export.h"
 
+#include <QLocalSocket>
 #include <QTcpSocket>
 
 namespace Server
@@ -44,14 +45,25 @@ namespace Server
         using List = QList<Client*>;
 
         //* constructor
-        explicit Client( QObject*, QTcpSocket* = nullptr );
+        explicit Client( QObject*, Transport = Transport::Tcp );
+
+        //* constructor, from accepted tcp connection
+        explicit Client( QObject*, QTcpSocket* );
+
+        //* constructor, from accepted local connection
+        explicit Client( QObject*, QLocalSocket* );
 
         //* id
         quint32 id() const
         { return id_; }
 
         /** returns true if message could be sent */
-        void sendCommand( const ServerCommand& );
+        void sendCommand( const ServerCommand& command )
+        { sendFrame( frame( command ) ); }
+
+        //* encoded command frame, to be sent with sendFrame
+        /** this allows encoding a command only once when sending it to several clients */
+        static QByteArray frame( const ServerCommand& );
 
         //* used to retrieve client matching id
         using SameIdFTor = Base::Functor::Unary<Client, quint32, &Client::id>;
@@ -61,10 +73,12 @@ namespace Server
         //* emitted when a message is available
         void commandAvailable( Server::ServerCommand );
 
-        private:
+        protected:
+
+        //* process received buffer
+        void _processBuffer( qint32, const QByteArray& ) override;
 
-        //* process buffer
-        void _parseBuffer( qint32, QByteArray );
+        private:
 
         //* client counter
         static quint32& _counter();
@@ -23,6 +23,135 @@
 
 #include <QStringList>
 
+namespace
+{
+
+    //* encoding version
+    const quint8 encodingVersion = 1;
+
+    //* option flag
+    const quint64 hasOption = 1<<0;
+
+    //* compact binary writer
+    class Writer
+    {
+        public:
+
+        //* unsigned varint
+        void write( quint64 value )
+        {
+            while( value >= 0x80 )
+            {
+                buffer.append( char( (value&0x7f)|0x80 ) );
+                value >>= 7;
+            }
+
+            buffer.append( char( value ) );
+        }
+
+        //* signed varint, zigzag encoded
+        void writeSigned( qint64 value )
+        { write( (quint64( value ) << 1)^quint64( value >> 63 ) ); }
+
+        //* bytes, prefixed by size
+        void write( const QByteArray& value )
+        {
+            write( quint64( value.size() ) );
+            buffer.append( value );
+        }
+
+        //* string
+        void write( const QString& value )
+        { write( value.toUtf8() ); }
+
+        //* buffer
+        QByteArray buffer;
+
+    };
+
+    //* compact binary reader, with bounds checking
+    class Reader
+    {
+        public:
+
+        //* constructor
+        explicit Reader( const QByteArray& buffer ):
+            data_( buffer.constData() ),
+            end_( buffer.constData() + buffer.size() )
+        {}
+
+        //* true if no error occured
+        bool isValid() const
+        { return valid_; }
+
+        //* unsigned varint
+        quint64 read()
+        {
+            quint64 value = 0;
+            for( int shift = 0; shift < 64; shift += 7 )
+            {
+                if( data_ == end_ ) break;
+                const quint8 byte( *data_++ );
+                value |= quint64( byte&0x7f ) << shift;
+                if( !(byte&0x80) ) return value;
+            }
+
+            valid_ = false;
+            return 0;
+        }
+
+        //* signed varint
+        qint64 readSigned()
+        {
+            const quint64 value( read() );
+            return qint64( value >> 1 )^-qint64( value&1 );
+        }
+
+        //* bytes
+        QByteArray readBytes()
+        {
+            const quint64 size( read() );
+            if( !valid_ || size > quint64( end_ - data_ ) )
+            {
+                valid_ = false;
+                return QByteArray();
+            }
+
+            const QByteArray out( data_, int( size ) );
+            data_ += size;
+            return out;
+        }
+
+        //* string
+        QString readString()
+        {
+            const quint64 size( read() );
+            if( !valid_ || size > quint64( end_ - data_ ) )
+            {
+                valid_ = false;
+                return QString();
+            }
+
+            const auto out( QString::fromUtf8( data_, int( size ) ) );
+            data_ += size;
+            return out;
+        }
+
+        private:
+
+        //* current position
+        const char* data_ = nullptr;
+
+        //* end
+        const char* end_ = nullptr;
+
+        //* validity
+        bool valid_ = true;
+
+    };
+
+}
+
 namespace Server
 {
 
@@ -100,4 +229,82 @@ namespace Server
         return stream;
     }
 
+    //__________________________________________________
+    QByteArray ServerCommand::encoded() const
+    {
+        Writer writer;
+        writer.buffer.reserve( 64 );
+        writer.buffer.append( char( encodingVersion ) );
+
+        writer.writeSigned( timestamp_.isValid() ? qint64( timestamp_.unixTime() ):-1 );
+        writer.write( id_.name() );
+        writer.write( id_.user() );
+        writer.writeSigned( id_.processId() );
+        writer.write( quint64( command_ ) );
+
+        writer.write( quint64( arguments_.get().size() ) );
+        for( const auto& argument:arguments_.get() )
+        { writer.write( argument ); }
+
+        // option is only present for option commands
+        const bool option( !option_.name().isEmpty() );
+        writer.write( option ? hasOption:0 );
+        if( option )
+        {
+            QByteArray buffer;
+            {
+                QDataStream stream( &buffer, QIODevice::WriteOnly );
+                stream << static_cast<const Option&>( option_ );
+            }
+
+            writer.write( option_.name() );
+            writer.write( buffer );
+        }
+
+        return writer.buffer;
+    }
+
+    //__________________________________________________
+    bool ServerCommand::decode( const QByteArray& buffer, ServerCommand& command )
+    {
+        if( buffer.isEmpty() || quint8( buffer[0] ) != encodingVersion )
+        {
+            Debug::Throw(0) << "ServerCommand::decode - unrecognized version" << Qt::endl;
+            return false;
+        }
+
+        // skip version
+        Reader reader( buffer );
+        reader.read();
+
+        const qint64 time( reader.readSigned() );
+        if( time >= 0 ) command.timestamp_.setTime( time );
+        else command.timestamp_ = TimeStamp();
+
+        command.id_.setName( reader.readString() );
+        command.id_.setUser( reader.readString() );
+        command.id_.setProcessId( reader.readSigned() );
+        command.command_ = (ServerCommand::CommandType) reader.read();
+
+        QStringList arguments;
+        const quint64 count( reader.read() );
+        for( quint64 index = 0; index < count && reader.isValid(); ++index )
+        { arguments.append( reader.readString() ); }
+        command.arguments_ = CommandLineArguments( arguments );
+
+        if( reader.read()&hasOption )
+        {
+            const auto optionName( reader.readString() );
+            auto optionBuffer( reader.readBytes() );
+
+            Option option;
+            QDataStream stream( &optionBuffer, QIODevice::ReadOnly );
+            stream >> option;
+            command.option_ = XmlOption( optionName, option );
+        }
+
+        if( !reader.isValid() ) Debug::Throw(0) << "ServerCommand::decode - truncated buffer" << Qt::endl;
+        return reader.isValid();
+    }
+
 }
@@ -31,6 +31,7 @@
 #include "base_server_export.h"
 
 
+#include <QByteArray>
 #include <QDataStream>
 #include <QString>
 #include <QHash>
@@ -107,8 +108,18 @@ namespace Server
         const XmlOption& option() const
         { return option_; }
 
+        //* compact binary encoding, used for socket communication
+        /**
+        integers are stored as varints and strings as utf-8, prefixed by their size.
+        The client id is not encoded, since it is assigned by the receiving side
+        */
+        QByteArray encoded() const;
+
         //@}
 
+        //* decode command from compact binary encoding. Returns false on error
+        static bool decode( const QByteArray&, ServerCommand& );
+
         //*@name modifiers
         //@{
 
@@ -0,0 +1,85 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "ServerLockFile.h"
+#include "Debug.h"
+
+#include <QFile>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace Server
+{
+
+    //_______________________________________________________
+    ServerLockFile::ServerLockFile( const QString& fileName ):
+        Counter( QStringLiteral("Server::ServerLockFile") ),
+        fileName_( fileName )
+    {}
+
+    //_______________________________________________________
+    ServerLockFile::~ServerLockFile()
+    {
+        #if defined(Q_OS_UNIX)
+        // closing the descriptor releases the lock
+        if( descriptor_ >= 0 ) ::close( descriptor_ );
+        #endif
+    }
+
+    //_______________________________________________________
+    bool ServerLockFile::tryLock()
+    {
+        if( locked_ ) return true;
+
+        #if defined(Q_OS_UNIX)
+        if( descriptor_ < 0 )
+        {
+            descriptor_ = ::open( QFile::encodeName( fileName_ ).constData(), O_RDWR|O_CREAT|O_CLOEXEC, 0600 );
+            if( descriptor_ < 0 )
+            {
+                Debug::Throw(0) << "Server::ServerLockFile::tryLock - cannot open " << fileName_ << Qt::endl;
+                return false;
+            }
+        }
+
+        locked_ = ::flock( descriptor_, LOCK_EX|LOCK_NB ) == 0;
+        #endif
+
+        Debug::Throw() << "Server::ServerLockFile::tryLock - file: " << fileName_ << " locked: " << locked_ << Qt::endl;
+        return locked_;
+    }
+
+    //_______________________________________________________
+    void ServerLockFile::unlock()
+    {
+        if( !locked_ ) return;
+
+        #if defined(Q_OS_UNIX)
+        ::flock( descriptor_, LOCK_UN );
+        #endif
+
+        Debug::Throw() << "Server::ServerLockFile::unlock - file: " << fileName_ << Qt::endl;
+        locked_ = false;
+    }
+
+}
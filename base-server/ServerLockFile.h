@@ -0,0 +1,82 @@
+#ifndef ServerLockFile_h
+#define ServerLockFile_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "base_server_export.h"
+
+#include <QString>
+
+namespace Server
+{
+
+    //* advisory lock on a file, used to elect the server instance
+    /**
+    on unix platforms, the lock is taken with flock, which is released by the kernel
+    when the owning process exits, including on crash. On other platforms, locking always fails
+    */
+    class BASE_SERVER_EXPORT ServerLockFile: private Base::Counter<ServerLockFile>
+    {
+
+        public:
+
+        //* constructor
+        explicit ServerLockFile( const QString& );
+
+        //* destructor
+        ~ServerLockFile();
+
+        //* copy
+        ServerLockFile( const ServerLockFile& ) = delete;
+
+        //* assignment
+        ServerLockFile& operator = ( const ServerLockFile& ) = delete;
+
+        //* file name
+        const QString& fileName() const
+        { return fileName_; }
+
+        //* true if locked
+        bool isLocked() const
+        { return locked_; }
+
+        //* try acquire lock, without blocking. Returns true on success
+        bool tryLock();
+
+        //* release lock
+        void unlock();
+
+        private:
+
+        //* file name
+        QString fileName_;
+
+        //* file descriptor
+        int descriptor_ = -1;
+
+        //* locked
+        bool locked_ = false;
+
+    };
+
+}
+
+#endif
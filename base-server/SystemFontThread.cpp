@@ -0,0 +1,85 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "SystemFontThread.h"
+#include "Debug.h"
+
+#include <QMutexLocker>
+
+//______________________________________________________
+SystemFontThread::SystemFontThread( QObject* parent ):
+    QThread( parent ),
+    Counter( QStringLiteral("SystemFontThread") )
+{ qRegisterMetaType<SystemFonts>( "SystemFonts" ); }
+
+//______________________________________________________
+SystemFontThread::~SystemFontThread()
+{ wait(); }
+
+//______________________________________________________
+void SystemFontThread::discover( const QString& command )
+{
+
+    Debug::Throw() << "SystemFontThread::discover - command: " << command << Qt::endl;
+
+    {
+        // running thread picks up the new command before sending its results
+        QMutexLocker lock( &mutex_ );
+        command_ = command;
+        if( running_ ) return;
+        running_ = true;
+    }
+
+    // wait for previous run to return
+    wait();
+    start( QThread::LowPriority );
+
+}
+
+//______________________________________________________
+void SystemFontThread::run()
+{
+
+    forever
+    {
+
+        QString command;
+        int timeout;
+        {
+            QMutexLocker lock( &mutex_ );
+            command = command_;
+            timeout = timeout_;
+        }
+
+        const auto fonts( SystemFonts::discover( command, timeout ) );
+        if( !fonts.write() )
+        { Debug::Throw() << "SystemFontThread::run - unable to write startup cache" << Qt::endl; }
+
+        {
+            QMutexLocker lock( &mutex_ );
+            if( command != command_ ) continue;
+            running_ = false;
+        }
+
+        emit fontsAvailable( fonts );
+        return;
+
+    }
+
+}
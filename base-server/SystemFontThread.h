@@ -0,0 +1,85 @@
+#ifndef SystemFontThread_h
+#define SystemFontThread_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "SystemFonts.h"
+#include "base_server_export.h"
+
+#include <QMutex>
+#include <QThread>
+
+//* independent thread used to discover system fonts
+/**
+fonts are discovered and written to the startup cache in the background,
+so that the kde configuration command does not delay the first window.
+Requests received while running are queued, and only the result matching the last request is sent
+*/
+class BASE_SERVER_EXPORT SystemFontThread: public QThread, private Base::Counter<SystemFontThread>
+{
+
+    Q_OBJECT
+
+    public:
+
+    //* constructor
+    explicit SystemFontThread( QObject* = nullptr );
+
+    //* destructor
+    ~SystemFontThread() override;
+
+    //* timeout for the kde configuration command (ms)
+    void setTimeout( int value )
+    {
+        QMutexLocker lock( &mutex_ );
+        timeout_ = value;
+    }
+
+    //* discover fonts for a given kde configuration command
+    void discover( const QString& );
+
+    Q_SIGNALS:
+
+    //* fonts are available
+    void fontsAvailable( const SystemFonts& );
+
+    protected:
+
+    //* discover fonts
+    void run() override;
+
+    private:
+
+    //* mutex
+    QMutex mutex_;
+
+    //* kde configuration command
+    QString command_;
+
+    //* timeout (ms)
+    int timeout_ = 2000;
+
+    //* true when a request is being processed
+    bool running_ = false;
+
+};
+
+#endif
@@ -0,0 +1,202 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "SystemFonts.h"
+#include "Debug.h"
+#include "StartupProfiler.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+
+namespace
+{
+
+    //* magic number
+    static const quint32 magic = 0x53464331;
+
+    //* format version. To be incremented on any format change
+    static const quint32 version = 1;
+
+    //* data stream version, fixed so that Qt5 and Qt6 builds share caches
+    static const int streamVersion = QDataStream::Qt_5_15;
+
+    //* cache file
+    QString cacheFile()
+    {
+        const QString path( QStandardPaths::writableLocation( QStandardPaths::CacheLocation ) );
+        return path.isEmpty() ? QString():QDir( path ).filePath( QStringLiteral("system-fonts.cache") );
+    }
+
+}
+
+//________________________________________________________________
+SystemFonts SystemFonts::discover( const QString& command, int timeout )
+{
+
+    Debug::Throw() << "SystemFonts::discover - command: " << command << Qt::endl;
+    StartupProfiler::Scope scope( "SystemFonts::discover" );
+
+    SystemFonts out;
+    out.valid_ = true;
+    out.command_ = command;
+
+    // configuration paths
+    QStringList paths;
+    const QStringList arguments( command.split( QRegularExpression( QStringLiteral("\\s") ), Qt::SkipEmptyParts ) );
+    if( !arguments.isEmpty() )
+    {
+
+        QProcess process;
+        process.start( arguments.front(), arguments.mid( 1 ) << QStringLiteral("--path") << QStringLiteral("config") );
+        if( process.waitForFinished( timeout ) && process.exitStatus() == QProcess::NormalExit )
+        {
+
+            for( const auto& path:QString::fromLocal8Bit( process.readAllStandardOutput() ).trimmed().split( QLatin1Char(':'), Qt::SkipEmptyParts ) )
+            { out.files_.append( FileStamp( QDir( path ).filePath( QStringLiteral("kdeglobals") ), -1 ) ); }
+
+        } else if( process.state() != QProcess::NotRunning ) {
+
+            Debug::Throw(0) << "SystemFonts::discover - " << arguments.front() << " timed out" << Qt::endl;
+            process.kill();
+            process.waitForFinished( 1000 );
+
+        }
+
+    }
+
+    if( out.files_.isEmpty() )
+    {
+        // add some files manually in case the above failed
+        const QDir home( QDir::homePath() );
+        out.files_.append( FileStamp( home.filePath( QStringLiteral(".config/kdeglobals") ), -1 ) );
+        out.files_.append( FileStamp( home.filePath( QStringLiteral(".kde/share/config/kdeglobals") ), -1 ) );
+        out.files_.append( FileStamp( home.filePath( QStringLiteral(".kde4/share/config/kdeglobals") ), -1 ) );
+    }
+
+    for( auto& file:out.files_ )
+    {
+
+        // check file existence
+        file.second = _modified( file.first );
+        if( file.second < 0 || !( out.font_.isEmpty() || out.fixedFont_.isEmpty() ) ) continue;
+
+        Debug::Throw() << "SystemFonts::discover - file: " << file.first << Qt::endl;
+
+        // load settings
+        QSettings settings( file.first, QSettings::IniFormat );
+
+        // generic font
+        if( out.font_.isEmpty() && settings.contains( QStringLiteral("font") ) )
+        { out.font_ = settings.value( QStringLiteral("font") ).toStringList().join( QStringLiteral(",") ); }
+
+        // fixed font
+        if( out.fixedFont_.isEmpty() && settings.contains( QStringLiteral("fixed") ) )
+        { out.fixedFont_ = settings.value( QStringLiteral("fixed") ).toStringList().join( QStringLiteral(",") ); }
+
+    }
+
+    return out;
+
+}
+
+//________________________________________________________________
+SystemFonts SystemFonts::read( const QString& command )
+{
+
+    const QString fileName( cacheFile() );
+    if( fileName.isEmpty() ) return SystemFonts();
+
+    QFile in( fileName );
+    if( !in.open( QIODevice::ReadOnly ) ) return SystemFonts();
+
+    QDataStream stream( &in );
+    stream.setVersion( streamVersion );
+
+    quint32 fileMagic = 0;
+    quint32 fileVersion = 0;
+    QString key;
+    stream >> fileMagic >> fileVersion;
+    if( fileMagic != magic || fileVersion != version ) return SystemFonts();
+
+    stream >> key;
+    if( key != _key( command ) ) return SystemFonts();
+
+    SystemFonts out;
+    out.command_ = command;
+    stream >> out.font_ >> out.fixedFont_ >> out.files_;
+    if( stream.status() != QDataStream::Ok || out.files_.isEmpty() ) return SystemFonts();
+
+    out.valid_ = out.isUpToDate();
+    return out.valid_ ? out:SystemFonts();
+
+}
+
+//________________________________________________________________
+bool SystemFonts::write() const
+{
+
+    if( !valid_ ) return false;
+
+    const QString fileName( cacheFile() );
+    if( fileName.isEmpty() ) return false;
+    QDir().mkpath( QFileInfo( fileName ).absolutePath() );
+
+    QSaveFile out( fileName );
+    if( !out.open( QIODevice::WriteOnly ) ) return false;
+
+    QDataStream stream( &out );
+    stream.setVersion( streamVersion );
+    stream << magic << version << _key( command_ ) << font_ << fixedFont_ << files_;
+    return out.commit();
+
+}
+
+//________________________________________________________________
+bool SystemFonts::isUpToDate() const
+{
+    for( const auto& file:files_ )
+    { if( _modified( file.first ) != file.second ) return false; }
+
+    return true;
+}
+
+//________________________________________________________________
+qint64 SystemFonts::_modified( const QString& file )
+{
+    const QFileInfo info( file );
+    return ( info.exists() && info.lastModified().isValid() ) ? info.lastModified().toMSecsSinceEpoch():-1;
+}
+
+//________________________________________________________________
+QString SystemFonts::_key( const QString& command )
+{
+    // configuration paths returned by the kde configuration command depend on these variables
+    QString out( command );
+    for( const auto& variable:{ "HOME", "KDEHOME", "XDG_CONFIG_HOME", "XDG_CONFIG_DIRS" } )
+    { out += QLatin1Char('\n') + QString::fromLocal8Bit( qgetenv( variable ) ); }
+
+    return out;
+}
@@ -0,0 +1,100 @@
+#ifndef SystemFonts_h
+#define SystemFonts_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "base_server_export.h"
+
+#include <QList>
+#include <QMetaType>
+#include <QPair>
+#include <QString>
+
+//* system fonts, as read from kde global configuration files
+/**
+fonts are discovered by running the kde configuration command, to get the list of configuration paths,
+and parsing the kdeglobals file found in each path.
+Results are stored in a small startup cache, together with the modification time of each configuration file,
+so that later launches can skip the discovery as long as none of the files has changed
+*/
+class BASE_SERVER_EXPORT SystemFonts
+{
+
+    public:
+
+    //* discover fonts. Blocking, the kde configuration command is abandoned after timeout milliseconds
+    static SystemFonts discover( const QString& command, int timeout );
+
+    //* read fonts from startup cache. Returns invalid fonts if not found or outdated
+    static SystemFonts read( const QString& command );
+
+    //* write fonts to startup cache
+    bool write() const;
+
+    //* true if valid
+    bool isValid() const
+    { return valid_; }
+
+    //* true if none of the configuration files has changed since discovery
+    bool isUpToDate() const;
+
+    //* kde configuration command
+    const QString& command() const
+    { return command_; }
+
+    //* generic font, as a string suitable for QFont::fromString. Empty if not found
+    const QString& font() const
+    { return font_; }
+
+    //* fixed font, as a string suitable for QFont::fromString. Empty if not found
+    const QString& fixedFont() const
+    { return fixedFont_; }
+
+    private:
+
+    //* configuration file and modification time, in milliseconds, or -1 if missing
+    using FileStamp = QPair<QString, qint64>;
+
+    //* modification time of a given file, or -1 if missing
+    static qint64 _modified( const QString& );
+
+    //* cache key, from command and relevant environment
+    static QString _key( const QString& );
+
+    //* valid flag
+    bool valid_ = false;
+
+    //* kde configuration command
+    QString command_;
+
+    //* generic font
+    QString font_;
+
+    //* fixed font
+    QString fixedFont_;
+
+    //* configuration files, in lookup order
+    QList<FileStamp> files_;
+
+};
+
+Q_DECLARE_METATYPE( SystemFonts )
+
+#endif
@@ -20,6 +20,7 @@
 *
 *******************************************************************************/
 
+#include "LruCache.h"
 #include "SvgId.h"
 
 #include <QString>
@@ -64,7 +65,7 @@ namespace Svg
     //@}
 
     //* map size and pixmap
-    using PixmapCache = QMap< SvgId, QPixmap >;
+    using PixmapCache = Base::LruCache< SvgId, QPixmap >;
     using ImageCache = QMap< SvgId, QImage >;
 
 };
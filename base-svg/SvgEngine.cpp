@@ -18,7 +18,7 @@
 *******************************************************************************/
 
 #include "SvgEngine.h"
-#include "CppUtil.h"
+#include "PixmapCache.h"
 #include "Svg.h"
 #include "SvgPlasmaInterface.h"
 #include "XmlOptions.h"
@@ -38,8 +38,10 @@ namespace Svg
 
     //__________________________________________________________
     SvgEngine::SvgEngine():
-        thread_( new SvgThread(this) )
-    { connect( thread_.get(), &SvgThread::imageCacheAvailable, this, &SvgEngine::_processImageCache ); }
+        cache_( 64*1024*1024 ),
+        diskCache_( new ImageDiskCache( QStringLiteral("svg"), 64*1024*1024, this ) ),
+        preloader_( new SvgPreloader( this ) )
+    { connect( preloader_, &SvgPreloader::imageCacheAvailable, this, &SvgEngine::_processImageCache ); }
 
     //__________________________________________________________
     bool SvgEngine::needsReloadOnPaletteChange() const
@@ -68,15 +70,13 @@ namespace Svg
             return true;
         }
 
-        // reload cache
+        // mark cache stale and regenerate in the background, most recently used first
         if( changed || configurationChanged )
         {
 
-            SvgId::List svgIdList;
-            std::copy( cache_.keyBegin(), cache_.keyEnd(), std::back_inserter( svgIdList ) );
-
-            cache_.clear();
-            preload( svgIdList );
+            cache_.setStale();
+            preloader_->setConfiguration( svgFile_, _styleSheetPalette(), renderer_.drawOverlay(), true );
+            preload( cache_.keys() );
 
             // update margins and outer padding
             margins_ = renderer_.margins();
@@ -94,26 +94,33 @@ namespace Svg
     void SvgEngine::preload( const SvgId::List& ids )
     {
 
-        if( ids.empty() ) return;
         if( !isValid() ) return;
-        if( thread_->isRunning() ) return;
 
-        if( plasmaInterface_ && plasmaInterface_->hasThemePalette() )
+        // use images rendered in previous sessions when available
+        SvgId::List missing;
+        for( const auto& id:ids )
         {
+            if( cache_.contains( id ) && !cache_.isStale( id ) ) continue;
+
+            const auto image( diskCache_->find( _key( id ) ) );
+            if( image.isNull() )
+            {
 
-            auto palette( plasmaInterface_->themePalette() );
-            thread_->createStyleSheet( palette );
+                missing.append( id );
 
-        } else {
+            } else {
 
-            QPalette palette;
-            thread_->createStyleSheet( palette );
+                const auto pixmap( QPixmap::fromImage( image ) );
+                cache_.insert( id, pixmap, Base::pixmapCost( pixmap ) );
 
+            }
         }
 
-        thread_->setSvgFile( svgFile_ );
-        thread_->setSvgIdList( ids );
-        thread_->start();
+        if( missing.empty() ) return;
+
+        // requests already pending are skipped by the preloader
+        preloader_->setConfiguration( svgFile_, _styleSheetPalette(), renderer_.drawOverlay() );
+        preloader_->request( missing );
 
     }
 
@@ -123,10 +130,11 @@ namespace Svg
 
         for( auto&& iter = cache.begin(); iter != cache.end(); ++iter )
         {
-            // insert only if not already in cache
-            const auto foundIter( cache_.lowerBound( iter.key() ) );
-            if( foundIter == cache_.cend() || !Base::areEquivalent( foundIter.key(), iter.key() ) )
-            { cache_.insert( foundIter, iter.key(), QPixmap::fromImage( iter.value() ) ); }
+            // insert only if not already in cache, or stale
+            if( cache_.contains( iter.key() ) && !cache_.isStale( iter.key() ) ) continue;
+            diskCache_->insert( _key( iter.key() ), iter.value() );
+            const auto pixmap( QPixmap::fromImage( iter.value() ) );
+            cache_.insert( iter.key(), pixmap, Base::pixmapCost( pixmap ) );
         }
 
     }
@@ -135,20 +143,44 @@ namespace Svg
     QPixmap SvgEngine::_get( const SvgId& id, bool )
     {
 
-        auto iter( cache_.lowerBound( id ) );
-        if( iter != cache_.end() && Base::areEquivalent( id, iter.key() ) ) return iter.value();
+        const auto cached( cache_.find( id ) );
+        if( cached ) return *cached;
         else
         {
-            // add to map
-            QPixmap pixmap( id.size() );
-            pixmap.fill( Qt::transparent );
-            renderer_.render( pixmap, id.id() );
+            // use image being rendered by the preloader, or rendered in previous sessions, or render
+            const auto key( _key( id ) );
+            auto image( preloader_->take( id ) );
+            if( !image.isNull() ) diskCache_->insert( key, image );
+            else image = diskCache_->find( key );
 
-            return cache_.insert(iter, id, pixmap ).value();
+            if( image.isNull() )
+            {
+                image = QImage( id.size(), QImage::Format_ARGB32_Premultiplied );
+                image.fill( Qt::transparent );
+                renderer_.render( image, id.id() );
+                diskCache_->insert( key, image );
+            }
+
+            // add to cache
+            const auto pixmap( QPixmap::fromImage( image ) );
+            return cache_.insert( id, pixmap, Base::pixmapCost( pixmap ) );
         }
 
     }
 
+    //__________________________________________________________
+    QPalette SvgEngine::_styleSheetPalette() const
+    { return ( plasmaInterface_ && plasmaInterface_->hasThemePalette() ) ? plasmaInterface_->themePalette():QPalette(); }
+
+    //__________________________________________________________
+    ImageDiskCache::Key SvgEngine::_key( const SvgId& id ) const
+    {
+        // palette only matters when used for the style sheet
+        const uint palette( renderer_.styleSheetIsUsed() ? ImageDiskCache::hash( hasThemePalette() ? themePalette():QPalette() ):0 );
+        const QString overlay( renderer_.drawOverlay() ? QStringLiteral("overlay"):QString() );
+        return ImageDiskCache::Key( svgFile_, id.size(), palette, id.id() + QLatin1Char( '/' ) + overlay );
+    }
+
     //________________________________________________
     bool SvgEngine::_loadSvg( bool forced )
     {
@@ -20,10 +20,10 @@
 *
 *******************************************************************************/
 
+#include "ImageDiskCache.h"
 #include "Margins.h"
+#include "SvgPreloader.h"
 #include "SvgRenderer.h"
-#include "SvgThread.h"
-#include "ThreadDeleter.h"
 #include "base_svg_export.h"
 
 #include <QSize>
@@ -104,9 +104,12 @@ namespace Svg
 
         private:
 
-        //* process image cache generated from thread
+        //* process image cache generated from preloader
         void _processImageCache( const Svg::ImageCache& );
 
+        //* palette used for style sheet
+        QPalette _styleSheetPalette() const;
+
         //* load svg
         bool _loadSvg( bool forced = false );
 
@@ -120,6 +123,9 @@ namespace Svg
         /** the file is stored into a cache to avoid all pixmaps manipulations */
         QPixmap _get( const SvgId&, bool fromCache = true );
 
+        //* disk cache key
+        ImageDiskCache::Key _key( const SvgId& ) const;
+
         //@}
 
         //* plasma interface
@@ -134,8 +140,11 @@ namespace Svg
         //* map size and pixmap
         PixmapCache cache_;
 
-        //* thread preload sizes
-        std::unique_ptr<SvgThread, Base::ThreadDeleter> thread_;
+        //* rendered images, persistent across sessions
+        ImageDiskCache* diskCache_ = nullptr;
+
+        //* preload sizes in worker threads
+        SvgPreloader* preloader_ = nullptr;
 
         //* margins
         Base::Margins margins_;
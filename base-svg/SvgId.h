@@ -21,6 +21,7 @@
 *******************************************************************************/
 
 #include "base_svg_export.h"
+#include <QHash>
 #include <QSize>
 #include <QString>
 #include <QList>
@@ -77,6 +78,10 @@ namespace Svg
 
     }
 
+    //* hash
+    inline uint qHash( const SvgId& svgId )
+    { return qHash( svgId.id() )^(uint( svgId.size().width() ) << 16)^uint( svgId.size().height() ); }
+
 };
 
 #endif
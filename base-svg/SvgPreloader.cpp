@@ -0,0 +1,212 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "SvgPreloader.h"
+#include "Debug.h"
+#include "StartupProfiler.h"
+#include "SvgRenderer.h"
+
+#include <QMetaObject>
+#include <QMetaType>
+#include <QMutexLocker>
+
+namespace Svg
+{
+
+    //______________________________________________________
+    SvgPreloader::SvgPreloader( QObject* parent, int threadCount ):
+        QObject( parent ),
+        Counter( QStringLiteral("Svg::SvgPreloader") )
+    {
+        Debug::Throw( QStringLiteral("Svg::SvgPreloader::SvgPreloader.\n") );
+        qRegisterMetaType<Svg::ImageCache>( "Svg::ImageCache" );
+
+        if( threadCount <= 0 ) threadCount = qBound( 1, QThread::idealThreadCount(), 4 );
+        for( int i = 0; i < threadCount; ++i )
+        {
+            threads_.emplace_back( new Thread( *this ) );
+            threads_.back()->start( QThread::LowPriority );
+        }
+    }
+
+    //______________________________________________________
+    SvgPreloader::~SvgPreloader()
+    {
+        {
+            QMutexLocker lock( &mutex_ );
+            abort_ = true;
+            queue_.clear();
+            queued_.clear();
+            requestCondition_.wakeAll();
+            renderCondition_.wakeAll();
+        }
+
+        for( const auto& thread:threads_ )
+        { thread->wait(); }
+    }
+
+    //______________________________________________________
+    bool SvgPreloader::isPending( const SvgId& id ) const
+    {
+        QMutexLocker lock( &mutex_ );
+        return queued_.contains( id ) || rendering_.contains( id ) || rendered_.contains( id );
+    }
+
+    //______________________________________________________
+    bool SvgPreloader::setConfiguration( const QString& file, const QPalette& palette, bool drawOverlay, bool forced )
+    {
+        QMutexLocker lock( &mutex_ );
+        if( !forced && generation_ > 0 && file == file_ && palette == palette_ && drawOverlay == drawOverlay_ ) return false;
+
+        file_ = file;
+        palette_ = palette;
+        drawOverlay_ = drawOverlay;
+        ++generation_;
+
+        // discard outdated requests and images
+        queue_.clear();
+        queued_.clear();
+        rendered_.clear();
+        renderCondition_.wakeAll();
+        return true;
+    }
+
+    //______________________________________________________
+    void SvgPreloader::request( const SvgId::List& ids )
+    {
+        QMutexLocker lock( &mutex_ );
+        for( const auto& id:ids )
+        {
+            if( queued_.contains( id ) || rendering_.contains( id ) || rendered_.contains( id ) ) continue;
+            queued_.insert( id );
+            queue_.enqueue( id );
+        }
+
+        requestCondition_.wakeAll();
+    }
+
+    //______________________________________________________
+    QImage SvgPreloader::take( const SvgId& id )
+    {
+        QMutexLocker lock( &mutex_ );
+
+        // not started yet. Caller renders it
+        if( queued_.remove( id ) )
+        {
+            queue_.removeOne( id );
+            return QImage();
+        }
+
+        // wait for render in progress
+        while( rendering_.contains( id ) && !abort_ )
+        { renderCondition_.wait( &mutex_ ); }
+
+        return rendered_.take( id );
+    }
+
+    //______________________________________________________
+    void SvgPreloader::_process()
+    {
+
+        // renderer is created in the worker thread
+        std::unique_ptr<SvgRenderer> renderer;
+        int generation = 0;
+
+        forever
+        {
+
+            // get next request, and configuration if changed
+            SvgId id( ( QSize() ) );
+            QString file;
+            QPalette palette;
+            bool drawOverlay = true;
+            int current = 0;
+            bool reload = false;
+            {
+                QMutexLocker lock( &mutex_ );
+                while( queue_.isEmpty() && !abort_ ) requestCondition_.wait( &mutex_ );
+                if( abort_ ) return;
+
+                id = queue_.dequeue();
+                queued_.remove( id );
+                rendering_.insert( id );
+
+                current = generation_;
+                reload = current != generation || !renderer;
+                if( reload )
+                {
+                    file = file_;
+                    palette = palette_;
+                    drawOverlay = drawOverlay_;
+                }
+            }
+
+            // update renderer, using the configuration snapshot rather than options, which are not thread safe
+            if( reload )
+            {
+                renderer.reset( new SvgRenderer );
+                renderer->createStyleSheet( palette );
+                renderer->load( file );
+                renderer->setDrawOverlay( drawOverlay );
+                generation = current;
+            }
+
+            // render
+            QImage image;
+            if( renderer->isValid() )
+            {
+                StartupProfiler::Scope scope( "SvgPreloader::render" );
+                image = QImage( id.size(), QImage::Format_ARGB32_Premultiplied );
+                image.fill( Qt::transparent );
+                renderer->render( image, id.id() );
+            }
+
+            // store, unless configuration has changed in the meantime
+            QMutexLocker lock( &mutex_ );
+            rendering_.remove( id );
+            if( current == generation_ && !image.isNull() )
+            {
+                rendered_.insert( id, image );
+                if( !deliveryScheduled_ )
+                {
+                    deliveryScheduled_ = true;
+                    QMetaObject::invokeMethod( this, [this]() { _deliver(); }, Qt::QueuedConnection );
+                }
+            }
+
+            renderCondition_.wakeAll();
+
+        }
+
+    }
+
+    //______________________________________________________
+    void SvgPreloader::_deliver()
+    {
+        ImageCache images;
+        {
+            QMutexLocker lock( &mutex_ );
+            deliveryScheduled_ = false;
+            std::swap( images, rendered_ );
+        }
+
+        if( !images.isEmpty() ) emit imageCacheAvailable( images );
+    }
+
+}
@@ -0,0 +1,180 @@
+#ifndef SvgPreloader_h
+#define SvgPreloader_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "Svg.h"
+#include "SvgId.h"
+#include "base_svg_export.h"
+
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QPalette>
+#include <QQueue>
+#include <QSet>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <memory>
+#include <vector>
+
+namespace Svg
+{
+
+    //* render svg ids in worker threads
+    /**
+    each worker uses its own renderer. Requests are queued and deduplicated,
+    and rendered images are delivered in batches, in the thread the preloader lives in
+    */
+    class BASE_SVG_EXPORT SvgPreloader: public QObject, private Base::Counter<SvgPreloader>
+    {
+
+        Q_OBJECT
+
+        public:
+
+        //* constructor
+        explicit SvgPreloader( QObject* = nullptr, int threadCount = 0 );
+
+        //* destructor
+        ~SvgPreloader() override;
+
+        //*@name accessors
+        //@{
+
+        //* true if id is queued, being rendered, or rendered but not delivered
+        bool isPending( const SvgId& ) const;
+
+        //@}
+
+        //*@name modifiers
+        //@{
+
+        //* configuration
+        /**
+        returns true if changed or forced, in which case pending requests are discarded,
+        and workers reload the svg file before rendering new requests
+        */
+        bool setConfiguration( const QString& file, const QPalette&, bool drawOverlay, bool forced = false );
+
+        //* add requests. Ids already pending are skipped
+        void request( const SvgId::List& );
+
+        //* take image for a given id
+        /**
+        waits if the id is being rendered, and removes it from queued requests otherwise.
+        Returns a null image if no rendered image is available, in which case the caller is expected to render it
+        */
+        QImage take( const SvgId& );
+
+        //@}
+
+        Q_SIGNALS:
+
+        //* emitted when rendered images are available
+        void imageCacheAvailable( const Svg::ImageCache& );
+
+        private:
+
+        //* worker thread
+        class Thread: public QThread
+        {
+
+            public:
+
+            //* constructor
+            explicit Thread( SvgPreloader& preloader ):
+                preloader_( preloader )
+            {}
+
+            protected:
+
+            //* process requests
+            void run() override
+            { preloader_._process(); }
+
+            private:
+
+            //* parent preloader
+            SvgPreloader& preloader_;
+
+        };
+
+        //* process requests until aborted. Called from worker threads
+        void _process();
+
+        //* deliver rendered images. Called in the thread the preloader lives in
+        void _deliver();
+
+        //* mutex
+        mutable QMutex mutex_;
+
+        //* wait condition for workers
+        QWaitCondition requestCondition_;
+
+        //* wait condition for rendered images
+        QWaitCondition renderCondition_;
+
+        //*@name configuration
+        //@{
+
+        //* svg file
+        QString file_;
+
+        //* palette
+        QPalette palette_;
+
+        //* overlay
+        bool drawOverlay_ = true;
+
+        //* generation, incremented each time configuration changes
+        /** workers apply the configuration above to their renderer when generation changes, and never read options directly */
+        int generation_ = 0;
+
+        //@}
+
+        //* queued requests
+        QQueue<SvgId> queue_;
+
+        //* queued ids
+        QSet<SvgId> queued_;
+
+        //* ids being rendered
+        QSet<SvgId> rendering_;
+
+        //* rendered images, not delivered yet
+        ImageCache rendered_;
+
+        //* true when delivery is scheduled
+        bool deliveryScheduled_ = false;
+
+        //* abort flag
+        bool abort_ = false;
+
+        //* worker threads
+        std::vector<std::unique_ptr<Thread>> threads_;
+
+    };
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 
 #include <QPainter>
 #include <QDomDocument>
+#include <QtMath>
 
 #if WITH_ZLIB
 #include <zlib.h>
@@ -33,17 +34,15 @@ namespace Svg
 
     //________________________________________________
     bool SvgRenderer::updateConfiguration()
-    {
-        bool drawOverlay( XmlOptions::get().get<bool>( QStringLiteral("SVG_DRAW_OVERLAY") ) );
-        if( drawOverlay == drawOverlay_ ) return false;
-        drawOverlay_ = drawOverlay;
-        return true;
-    }
+    { return setDrawOverlay( XmlOptions::get().get<bool>( QStringLiteral("SVG_DRAW_OVERLAY") ) ); }
 
     //________________________________________________
     bool SvgRenderer::load( const QString& filename )
     {
 
+        // rasterized elements are invalidated
+        tiles_.clear();
+
         // load filename directly
         bool loaded( BaseSvgRenderer::load( filename ) );
 
@@ -236,7 +235,7 @@ namespace Svg
         {
 
             // compute painting rect
-            QSizeF overlaySize = boundsOnElement(Svg::Overlay).size();
+            QSizeF overlaySize = _tile( Svg::Overlay ).size;
 
             // size hints
             if( overlayHints_ & OverlayStretch ) overlaySize = size;
@@ -254,7 +253,7 @@ namespace Svg
             if( overlayHints_ & OverlayPosRight ) overlayPainter.translate( device.width() - overlayRect.width(), 0 );
             if( overlayHints_ & OverlayPosBottom ) overlayPainter.translate( 0, device.height() - overlayRect.height() );
 
-            BaseSvgRenderer::render( &overlayPainter, Svg::Overlay, overlayRect );
+            _drawTile( overlayPainter, Svg::Overlay, overlayRect );
             overlayPainter.end();
 
             // draw on main painter
@@ -318,15 +317,15 @@ namespace Svg
         if( padding )
         {
             centerRect.adjust(
-                boundsOnElement( prefix+Svg::Left ).width(),
-                boundsOnElement( prefix+Svg::Top ).height(),
-                -boundsOnElement( prefix+Svg::Right ).width(),
-                -boundsOnElement( prefix+Svg::Bottom ).height() );
+                _tile( prefix+Svg::Left ).size.width(),
+                _tile( prefix+Svg::Top ).size.height(),
+                -_tile( prefix+Svg::Right ).size.width(),
+                -_tile( prefix+Svg::Bottom ).size.height() );
         }
 
         // center
         if( centerRect.isValid() && elements & Center )
-        { BaseSvgRenderer::render( &painter, prefix+Svg::Center, centerRect ); }
+        { _drawTile( painter, prefix+Svg::Center, centerRect ); }
 
         if( padding )
         {
@@ -335,14 +334,14 @@ namespace Svg
             {
                 // topLeft corner
                 painter.setClipRect( QRect( targetRect.topLeft(), targetRect.center() ) );
-                BaseSvgRenderer::render( &painter, prefix+Svg::TopLeft, QRectF( QPointF( 0, 0 ), boundsOnElement( prefix+Svg::TopLeft ).size() ) );
+                _drawTile( painter, prefix+Svg::TopLeft, QRectF( QPointF( 0, 0 ), _tile( prefix+Svg::TopLeft ).size ) );
             }
 
             if( elements & TopRight )
             {
                 // topRight corner
                 painter.setClipRect( QRect( QPoint(  targetRect.center().x()+1, targetRect.top() ), QPoint( targetRect.right(), targetRect.center().y() ) ) );
-                BaseSvgRenderer::render( &painter, prefix+Svg::TopRight, QRectF( QPointF( centerRect.right(), 0 ), boundsOnElement( prefix+Svg::TopRight ).size() ) );
+                _drawTile( painter, prefix+Svg::TopRight, QRectF( QPointF( centerRect.right(), 0 ), _tile( prefix+Svg::TopRight ).size ) );
             }
 
             if( elements & BottomLeft )
@@ -350,14 +349,14 @@ namespace Svg
 
                 // topRight corner
                 painter.setClipRect( QRect( QPoint(  targetRect.left(), targetRect.center().y()+1 ), QPoint( targetRect.center().x(), targetRect.bottom() ) ) );
-                BaseSvgRenderer::render( &painter, prefix+Svg::BottomLeft, QRectF( QPointF( 0, centerRect.bottom() ), boundsOnElement( prefix+Svg::BottomRight ).size() ) );
+                _drawTile( painter, prefix+Svg::BottomLeft, QRectF( QPointF( 0, centerRect.bottom() ), _tile( prefix+Svg::BottomRight ).size ) );
             }
 
             if( elements & BottomRight )
             {
                 // bottomRight corner
                 painter.setClipRect( QRect( targetRect.center()+QPoint( 1, 1 ), targetRect.bottomRight() ) );
-                BaseSvgRenderer::render( &painter, prefix+Svg::BottomRight, QRectF( centerRect.bottomRight(), boundsOnElement( prefix+Svg::BottomRight ).size() ) );
+                _drawTile( painter, prefix+Svg::BottomRight, QRectF( centerRect.bottomRight(), _tile( prefix+Svg::BottomRight ).size ) );
             }
 
             if( centerRect.width() > 0 )
@@ -367,14 +366,14 @@ namespace Svg
                 {
                     // top size
                     painter.setClipRect( QRect( targetRect.topLeft(), QPoint( targetRect.right(), targetRect.center().y() ) ) );
-                    BaseSvgRenderer::render( &painter, prefix+Svg::Top, QRectF( QPointF( centerRect.left(), 0 ), QSizeF( centerRect.width(), boundsOnElement( prefix+Svg::Top ).height() ) ) );
+                    _drawTile( painter, prefix+Svg::Top, QRectF( QPointF( centerRect.left(), 0 ), QSizeF( centerRect.width(), _tile( prefix+Svg::Top ).size.height() ) ) );
                 }
 
                 if( elements & Bottom )
                 {
                     // bottom size
                     painter.setClipRect( QRect( QPoint( targetRect.left(), targetRect.center().y()+1 ), targetRect.bottomRight() ) );
-                    BaseSvgRenderer::render( &painter, prefix+Svg::Bottom, QRectF( centerRect.bottomLeft(), QSizeF( centerRect.width(), boundsOnElement( prefix+Svg::Bottom ).height() ) ) );
+                    _drawTile( painter, prefix+Svg::Bottom, QRectF( centerRect.bottomLeft(), QSizeF( centerRect.width(), _tile( prefix+Svg::Bottom ).size.height() ) ) );
                 }
 
             }
@@ -386,13 +385,13 @@ namespace Svg
                 {
                     // left side
                     painter.setClipRect( QRect( targetRect.topLeft(), QPoint( targetRect.center().x(), targetRect.bottom() ) ) );
-                    BaseSvgRenderer::render( &painter, prefix+Svg::Left, QRectF( QPointF( 0, centerRect.top() ), QSizeF( boundsOnElement( prefix+Svg::Left ).width(), centerRect.height() ) ) );
+                    _drawTile( painter, prefix+Svg::Left, QRectF( QPointF( 0, centerRect.top() ), QSizeF( _tile( prefix+Svg::Left ).size.width(), centerRect.height() ) ) );
                 }
 
                 if( elements & Right )
                 {
                     painter.setClipRect( QRect( QPoint( targetRect.center().x()+1, targetRect.top() ), targetRect.bottomRight() ) );
-                    BaseSvgRenderer::render( &painter, prefix+Svg::Right, QRectF( centerRect.topRight(), QSizeF( boundsOnElement( prefix+Svg::Right ).width(), centerRect.height() ) ) );
+                    _drawTile( painter, prefix+Svg::Right, QRectF( centerRect.topRight(), QSizeF( _tile( prefix+Svg::Right ).size.width(), centerRect.height() ) ) );
                 }
 
             }
@@ -403,4 +402,51 @@ namespace Svg
         return;
     }
 
+    //________________________________________________
+    SvgRenderer::Tile SvgRenderer::_tile( const QString& id )
+    {
+
+        auto iter( tiles_.constFind( id ) );
+        if( iter != tiles_.constEnd() ) return iter.value();
+
+        // render element once, at its natural size
+        Tile tile;
+        tile.size = boundsOnElement( id ).size();
+        const QSize size( qCeil( tile.size.width() ), qCeil( tile.size.height() ) );
+        if( !size.isEmpty() )
+        {
+            tile.image = QImage( size, QImage::Format_ARGB32_Premultiplied );
+            tile.image.fill( Qt::transparent );
+
+            QPainter painter( &tile.image );
+            BaseSvgRenderer::render( &painter, id, QRectF( QPointF( 0, 0 ), tile.size ) );
+        }
+
+        tiles_.insert( id, tile );
+        return tile;
+
+    }
+
+    //________________________________________________
+    void SvgRenderer::_drawTile( QPainter& painter, const QString& id, const QRectF& rect )
+    {
+
+        const Tile tile( _tile( id ) );
+        if( tile.image.isNull() || rect.isEmpty() ) return;
+
+        // blit when size matches, stretch otherwise
+        if( rect.size() == tile.size )
+        {
+
+            painter.drawImage( rect.topLeft(), tile.image );
+
+        } else {
+
+            painter.setRenderHint( QPainter::SmoothPixmapTransform, true );
+            painter.drawImage( rect, tile.image, QRectF( QPointF( 0, 0 ), tile.size ) );
+
+        }
+
+    }
+
 }
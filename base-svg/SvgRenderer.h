@@ -25,10 +25,14 @@
 #include "base_svg_export.h"
 
 #include <QByteArray>
+#include <QHash>
+#include <QImage>
 #include <QIODevice>
 #include <QPaintDevice>
 #include <QPalette>
 
+class QPainter;
+
 //* construct pixmap of given size using Svg renderer
 namespace Svg
 {
@@ -68,6 +72,10 @@ namespace Svg
         bool isValid() const
         { return isValid_; }
 
+        //* true if overlay (when present) is drawn
+        bool drawOverlay() const
+        { return drawOverlay_; }
+
         //* margins
         Base::Margins margins() const;
 
@@ -79,9 +87,17 @@ namespace Svg
         //*@name modifiers
         //@{
 
-        //* configuration
+        //* configuration, read from options. Must be called from the main thread
         bool updateConfiguration();
 
+        //* overlay. Returns true if changed
+        bool setDrawOverlay( bool value )
+        {
+            if( drawOverlay_ == value ) return false;
+            drawOverlay_ = value;
+            return true;
+        }
+
         //* load file
         bool load( const QString& ) override;
 
@@ -105,6 +121,25 @@ namespace Svg
         /** need to use images in order to be able to run in separate thread */
         void _render( QImage&, QString prefix = QString(), SvgElements = All, bool padding = true );
 
+        //* rasterized element
+        class Tile
+        {
+            public:
+
+            //* image, at element natural size
+            QImage image;
+
+            //* element natural size
+            QSizeF size;
+
+        };
+
+        //* rasterized element matching id, created if needed
+        Tile _tile( const QString& );
+
+        //* draw rasterized element into a given rect, stretching as needed
+        void _drawTile( QPainter&, const QString&, const QRectF& );
+
         private:
 
         //* true if overlay (when present) must be drawn
@@ -154,6 +189,9 @@ namespace Svg
         //* prefix for loading mask
         QString maskPrefix_;
 
+        //* rasterized elements, indexed by id. Cleared when loading a new file
+        QHash<QString, Tile> tiles_;
+
     };
 
 };
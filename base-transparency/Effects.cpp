@@ -0,0 +1,494 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Effects.h"
+
+#include <QPainter>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EFFECTS_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define EFFECTS_HAVE_SSE2 0
+#endif
+
+#if EFFECTS_HAVE_SSE2 && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EFFECTS_HAVE_AVX2 1
+#define EFFECTS_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#else
+#define EFFECTS_HAVE_AVX2 0
+#endif
+
+namespace
+{
+
+    //! precision of alpha parameter, in fixed-point format 0.aprec
+    const int aprec = 16;
+
+    //! precision of state parameters, in fixed-point format 8.zprec
+    const int zprec = 7;
+
+    //! number of columns processed together in the vertical pass
+    const int tileWidth = 8;
+
+    //! minimum number of pixels for which the blur is split across threads
+    const int parallelThreshold = 256*256;
+
+    //! image buffer
+    class Buffer
+    {
+        public:
+
+        //! pixel at given position
+        uchar* pixel( int row, int column ) const
+        { return bits + row*bytesPerLine + 4*column; }
+
+        //! bits
+        uchar* bits = nullptr;
+
+        //! width
+        int width = 0;
+
+        //! height
+        int height = 0;
+
+        //! bytes per line
+        int bytesPerLine = 0;
+
+        //! blur parameter, in fixed-point format 0.aprec
+        int alpha = 0;
+    };
+
+    //! run function on [first,last) ranges of count items, using worker threads for large images
+    template<class Function>
+        void parallelFor( const Buffer& buffer, int count, int granularity, const Function& function )
+    {
+
+        int threads = 1;
+        if( buffer.width*buffer.height >= parallelThreshold )
+        { threads = qBound( 1, QThread::idealThreadCount(), 8 ); }
+
+        int chunk = (count + threads - 1)/threads;
+        chunk = granularity*((chunk + granularity - 1)/granularity);
+        if( threads <= 1 || chunk >= count )
+        {
+            function( 0, count );
+            return;
+        }
+
+        /*
+        chunks that cannot be started in the global thread pool are processed here,
+        which guarantees progress even when the pool is saturated
+        */
+        QSemaphore done;
+        int started = 0;
+        for( int first = chunk; first < count; first += chunk )
+        {
+            const int last = std::min( first + chunk, count );
+            if( QThreadPool::globalInstance()->tryStart( [&done, &function, first, last]() { function( first, last ); done.release(); } ) ) ++started;
+            else function( first, last );
+        }
+
+        function( 0, chunk );
+        done.acquire( started );
+
+    }
+
+    //*@name scalar implementation
+    //@{
+
+    //______________________________________________________________________________
+    inline void blurInner( uchar* pixel, int* z, int alpha )
+    {
+        for( int channel = 0; channel < 4; ++channel )
+        {
+            z[channel] += (alpha*((int(pixel[channel]) << zprec) - z[channel])) >> aprec;
+            pixel[channel] = uchar(z[channel] >> zprec);
+        }
+    }
+
+    //______________________________________________________________________________
+    void blurRowsScalar( const Buffer& buffer, int first, int last )
+    {
+        for( int row = first; row < last; ++row )
+        {
+            uchar* line = buffer.pixel( row, 0 );
+            int z[4];
+            for( int channel = 0; channel < 4; ++channel )
+            { z[channel] = int(line[channel]) << zprec; }
+
+            for( int index = 1; index < buffer.width; ++index ) blurInner( line + 4*index, z, buffer.alpha );
+            for( int index = buffer.width-2; index >= 0; --index ) blurInner( line + 4*index, z, buffer.alpha );
+        }
+    }
+
+    //______________________________________________________________________________
+    void blurColumnsScalar( const Buffer& buffer, int first, int last )
+    {
+        // columns are processed by tiles, so that memory is accessed one scanline segment at a time
+        for( int tile = first; tile < last; tile += tileWidth )
+        {
+            const int columns = std::min( tileWidth, last - tile );
+            int z[tileWidth][4];
+            for( int column = 0; column < columns; ++column )
+            {
+                const uchar* pixel = buffer.pixel( 0, tile + column );
+                for( int channel = 0; channel < 4; ++channel )
+                { z[column][channel] = int(pixel[channel]) << zprec; }
+            }
+
+            for( int row = 1; row < buffer.height-1; ++row )
+            {
+                uchar* pixel = buffer.pixel( row, tile );
+                for( int column = 0; column < columns; ++column )
+                { blurInner( pixel + 4*column, z[column], buffer.alpha ); }
+            }
+
+            for( int row = buffer.height-2; row >= 0; --row )
+            {
+                uchar* pixel = buffer.pixel( row, tile );
+                for( int column = 0; column < columns; ++column )
+                { blurInner( pixel + 4*column, z[column], buffer.alpha ); }
+            }
+        }
+    }
+
+    //@}
+
+    #if EFFECTS_HAVE_SSE2
+
+    //*@name SSE2 implementation, one pixel per register
+    //@{
+
+    //______________________________________________________________________________
+    inline __m128i load( const uchar* pixel )
+    {
+        int value;
+        std::memcpy( &value, pixel, 4 );
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( value ), zero ), zero );
+    }
+
+    //______________________________________________________________________________
+    inline void store( uchar* pixel, __m128i z )
+    {
+        __m128i value = _mm_srai_epi32( z, zprec );
+        value = _mm_packs_epi32( value, value );
+        value = _mm_packus_epi16( value, value );
+        const int packed = _mm_cvtsi128_si32( value );
+        std::memcpy( pixel, &packed, 4 );
+    }
+
+    //______________________________________________________________________________
+    // SSE2 has no 32 bits multiplication. The low 32 bits of the product are the same for signed and unsigned operands
+    inline __m128i multiply( __m128i a, __m128i b )
+    {
+        const __m128i even = _mm_mul_epu32( a, b );
+        const __m128i odd = _mm_mul_epu32( _mm_srli_si128( a, 4 ), _mm_srli_si128( b, 4 ) );
+        return _mm_unpacklo_epi32(
+            _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ),
+            _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+    }
+
+    //______________________________________________________________________________
+    inline void blurInnerSse2( uchar* pixel, __m128i& z, __m128i alpha )
+    {
+        const __m128i delta = _mm_sub_epi32( _mm_slli_epi32( load( pixel ), zprec ), z );
+        z = _mm_add_epi32( z, _mm_srai_epi32( multiply( alpha, delta ), aprec ) );
+        store( pixel, z );
+    }
+
+    //______________________________________________________________________________
+    void blurRowsSse2( const Buffer& buffer, int first, int last )
+    {
+        const __m128i alpha = _mm_set1_epi32( buffer.alpha );
+
+        // four rows are processed together, to interleave independent dependency chains
+        int row = first;
+        for( ; row + 4 <= last; row += 4 )
+        {
+            uchar* lines[4];
+            __m128i z[4];
+            for( int i = 0; i < 4; ++i )
+            {
+                lines[i] = buffer.pixel( row+i, 0 );
+                z[i] = _mm_slli_epi32( load( lines[i] ), zprec );
+            }
+
+            for( int index = 1; index < buffer.width; ++index )
+            {
+                for( int i = 0; i < 4; ++i )
+                { blurInnerSse2( lines[i] + 4*index, z[i], alpha ); }
+            }
+
+            for( int index = buffer.width-2; index >= 0; --index )
+            {
+                for( int i = 0; i < 4; ++i )
+                { blurInnerSse2( lines[i] + 4*index, z[i], alpha ); }
+            }
+        }
+
+        blurRowsScalar( buffer, row, last );
+    }
+
+    //______________________________________________________________________________
+    void blurColumnsSse2( const Buffer& buffer, int first, int last )
+    {
+        const __m128i alpha = _mm_set1_epi32( buffer.alpha );
+
+        int tile = first;
+        for( ; tile + tileWidth <= last; tile += tileWidth )
+        {
+            __m128i z[tileWidth];
+            for( int column = 0; column < tileWidth; ++column )
+            { z[column] = _mm_slli_epi32( load( buffer.pixel( 0, tile + column ) ), zprec ); }
+
+            for( int row = 1; row < buffer.height-1; ++row )
+            {
+                uchar* pixel = buffer.pixel( row, tile );
+                for( int column = 0; column < tileWidth; ++column )
+                { blurInnerSse2( pixel + 4*column, z[column], alpha ); }
+            }
+
+            for( int row = buffer.height-2; row >= 0; --row )
+            {
+                uchar* pixel = buffer.pixel( row, tile );
+                for( int column = 0; column < tileWidth; ++column )
+                { blurInnerSse2( pixel + 4*column, z[column], alpha ); }
+            }
+        }
+
+        blurColumnsScalar( buffer, tile, last );
+    }
+
+    //@}
+
+    #endif
+
+    #if EFFECTS_HAVE_AVX2
+
+    //*@name AVX2 implementation, two pixels per register
+    //@{
+
+    //______________________________________________________________________________
+    EFFECTS_AVX2 inline __m256i load2( const uchar* first, const uchar* second )
+    {
+        int values[2];
+        std::memcpy( values, first, 4 );
+        std::memcpy( values+1, second, 4 );
+        return _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( values ) ) );
+    }
+
+    //______________________________________________________________________________
+    EFFECTS_AVX2 inline __m128i pack2( __m256i z )
+    {
+        __m256i value = _mm256_srai_epi32( z, zprec );
+        value = _mm256_packs_epi32( value, value );
+        value = _mm256_packus_epi16( value, value );
+
+        // first pixel is in the low lane, second in the high lane
+        return _mm256_castsi256_si128( _mm256_permutevar8x32_epi32( value, _mm256_setr_epi32( 0, 4, 0, 0, 0, 0, 0, 0 ) ) );
+    }
+
+    //______________________________________________________________________________
+    EFFECTS_AVX2 inline __m256i update2( __m256i value, __m256i z, __m256i alpha )
+    {
+        const __m256i delta = _mm256_sub_epi32( _mm256_slli_epi32( value, zprec ), z );
+        return _mm256_add_epi32( z, _mm256_srai_epi32( _mm256_mullo_epi32( alpha, delta ), aprec ) );
+    }
+
+    //______________________________________________________________________________
+    // blur two pixels at unrelated positions, used for the horizontal pass
+    EFFECTS_AVX2 inline void blurInnerAvx2( uchar* first, uchar* second, __m256i& z, __m256i alpha )
+    {
+        z = update2( load2( first, second ), z, alpha );
+        const __m128i packed = pack2( z );
+        const int values[2] = { _mm_cvtsi128_si32( packed ), _mm_cvtsi128_si32( _mm_srli_si128( packed, 4 ) ) };
+        std::memcpy( first, values, 4 );
+        std::memcpy( second, values+1, 4 );
+    }
+
+    //______________________________________________________________________________
+    // blur two adjacent pixels, used for the vertical pass
+    EFFECTS_AVX2 inline void blurInnerAvx2( uchar* pixel, __m256i& z, __m256i alpha )
+    {
+        z = update2( _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( pixel ) ) ), z, alpha );
+        _mm_storel_epi64( reinterpret_cast<__m128i*>( pixel ), pack2( z ) );
+    }
+
+    //______________________________________________________________________________
+    EFFECTS_AVX2 void blurRowsAvx2( const Buffer& buffer, int first, int last )
+    {
+        const __m256i alpha = _mm256_set1_epi32( buffer.alpha );
+
+        // four rows are processed together, two per register
+        int row = first;
+        for( ; row + 4 <= last; row += 4 )
+        {
+            uchar* lines[4];
+            for( int i = 0; i < 4; ++i )
+            { lines[i] = buffer.pixel( row+i, 0 ); }
+
+            __m256i z[2] = {
+                _mm256_slli_epi32( load2( lines[0], lines[1] ), zprec ),
+                _mm256_slli_epi32( load2( lines[2], lines[3] ), zprec ) };
+
+            for( int index = 1; index < buffer.width; ++index )
+            {
+                blurInnerAvx2( lines[0] + 4*index, lines[1] + 4*index, z[0], alpha );
+                blurInnerAvx2( lines[2] + 4*index, lines[3] + 4*index, z[1], alpha );
+            }
+
+            for( int index = buffer.width-2; index >= 0; --index )
+            {
+                blurInnerAvx2( lines[0] + 4*index, lines[1] + 4*index, z[0], alpha );
+                blurInnerAvx2( lines[2] + 4*index, lines[3] + 4*index, z[1], alpha );
+            }
+        }
+
+        blurRowsScalar( buffer, row, last );
+    }
+
+    //______________________________________________________________________________
+    EFFECTS_AVX2 void blurColumnsAvx2( const Buffer& buffer, int first, int last )
+    {
+        const __m256i alpha = _mm256_set1_epi32( buffer.alpha );
+        const int registers = tileWidth/2;
+
+        int tile = first;
+        for( ; tile + tileWidth <= last; tile += tileWidth )
+        {
+            __m256i z[registers];
+            const uchar* line = buffer.pixel( 0, tile );
+            for( int i = 0; i < registers; ++i )
+            { z[i] = _mm256_slli_epi32( _mm256_cvtepu8_epi32( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( line + 8*i ) ) ), zprec ); }
+
+            for( int row = 1; row < buffer.height-1; ++row )
+            {
+                uchar* pixel = buffer.pixel( row, tile );
+                for( int i = 0; i < registers; ++i )
+                { blurInnerAvx2( pixel + 8*i, z[i], alpha ); }
+            }
+
+            for( int row = buffer.height-2; row >= 0; --row )
+            {
+                uchar* pixel = buffer.pixel( row, tile );
+                for( int i = 0; i < registers; ++i )
+                { blurInnerAvx2( pixel + 8*i, z[i], alpha ); }
+            }
+        }
+
+        blurColumnsScalar( buffer, tile, last );
+    }
+
+    //@}
+
+    #endif
+
+}
+
+namespace Transparency
+{
+
+    //______________________________________________________________________________
+    void Effects::shadowBlur(QImage &image, int radius, const QColor &color)
+    {
+        if (radius < 1) return;
+        expBlur(image, radius);
+
+        QPainter p(&image);
+        p.setCompositionMode(QPainter::CompositionMode_SourceIn);
+        p.fillRect(image.rect(), color);
+        p.end();
+    }
+
+    //______________________________________________________________________________
+    void Effects::expBlur(QImage &image, int radius, Implementation implementation)
+    {
+        if( radius < 1 || image.isNull() ) return;
+        if( image.depth() != 32 ) image = image.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+
+        // make sure the requested implementation is supported
+        const Implementation best = bestImplementation();
+        if( implementation == Implementation::Automatic || int(implementation) > int(best) )
+        { implementation = best; }
+
+        /* Calculate the alpha such that 90% of
+        the kernel is within the radius.
+        (Kernel extends to infinity)
+        */
+        Buffer buffer;
+        buffer.alpha = (int)((1 << aprec) * (1.0f - std::exp(-2.3f / (radius + 1.f))));
+
+        // detach once, before the image is shared across threads
+        buffer.bits = image.bits();
+        buffer.width = image.width();
+        buffer.height = image.height();
+        buffer.bytesPerLine = image.bytesPerLine();
+
+        using Pass = void (*)( const Buffer&, int, int );
+        Pass rows = &blurRowsScalar;
+        Pass columns = &blurColumnsScalar;
+        switch( implementation )
+        {
+            #if EFFECTS_HAVE_SSE2
+            case Implementation::Sse2:
+            rows = &blurRowsSse2;
+            columns = &blurColumnsSse2;
+            break;
+            #endif
+
+            #if EFFECTS_HAVE_AVX2
+            case Implementation::Avx2:
+            rows = &blurRowsAvx2;
+            columns = &blurColumnsAvx2;
+            break;
+            #endif
+
+            default: break;
+        }
+
+        parallelFor( buffer, buffer.height, 4, [&buffer, rows]( int first, int last ) { rows( buffer, first, last ); } );
+        parallelFor( buffer, buffer.width, tileWidth, [&buffer, columns]( int first, int last ) { columns( buffer, first, last ); } );
+    }
+
+    //______________________________________________________________________________
+    Effects::Implementation Effects::bestImplementation()
+    {
+        #if EFFECTS_HAVE_AVX2
+        static const bool hasAvx2 = __builtin_cpu_supports( "avx2" );
+        if( hasAvx2 ) return Implementation::Avx2;
+        #endif
+
+        #if EFFECTS_HAVE_SSE2
+        return Implementation::Sse2;
+        #else
+        return Implementation::Scalar;
+        #endif
+    }
+
+}
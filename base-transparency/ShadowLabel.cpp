@@ -21,7 +21,6 @@
 
 #include "ShadowLabel.h"
 #include "Debug.h"
-#include "Effects.h"
 
 namespace Transparency
 {
@@ -31,27 +30,16 @@ namespace Transparency
 
     if( text().isEmpty() ) return;
 
-    QPixmap pixmap( size() );
-    pixmap.fill( Qt::transparent );
-
-    {
-      QPainter painter( &pixmap );
-      painter.setClipRect( event->rect() );
-      painter.setPen( palette().color( QPalette::WindowText ) );
-      painter.setFont( font() );
-      painter.drawText( contentsRect(), alignment(), text() );
-      painter.end();
-    }
-
     QPainter painter( this );
+    painter.setClipRect( event->rect() );
+
+    // shadow is only rendered again when text, font, geometry or shadow properties change
     if( _shadowOffset() > 0 && _shadowColor().isValid() )
-    {
-      QImage image( pixmap.toImage() );
-      Transparency::Effects::shadowBlur(image, _shadowOffset(), _shadowColor() );
-      painter.drawImage( rect().topLeft(), image);
-    }
+    { shadowCache_.draw( painter, contentsRect(), alignment(), text(), font(), _shadowColor(), _shadowOffset(), devicePixelRatioF() ); }
 
-    painter.drawPixmap( rect().topLeft(), pixmap );
+    painter.setPen( palette().color( QPalette::WindowText ) );
+    painter.setFont( font() );
+    painter.drawText( contentsRect(), alignment(), text() );
     painter.end();
 
   }
@@ -21,6 +21,7 @@
 *******************************************************************************/
 
 #include "Counter.h"
+#include "ShadowTextCache.h"
 #include "base_transparency_export.h"
 
 #include <QColor>
@@ -51,11 +52,19 @@ namespace Transparency
 
         //* shadow offset
         void setShadowOffset( int value )
-        { shadowOffset_ = value; }
+        {
+            if( shadowOffset_ == value ) return;
+            shadowOffset_ = value;
+            shadowCache_.clear();
+        }
 
         //* shadow color
         void setShadowColor( const QColor& color )
-        { shadowColor_ = color; }
+        {
+            if( shadowColor_ == color ) return;
+            shadowColor_ = color;
+            shadowCache_.clear();
+        }
 
         protected:
 
@@ -77,6 +86,8 @@ namespace Transparency
         //* shadow color
         QColor shadowColor_;
 
+        //* shadow cache
+        ShadowTextCache shadowCache_;
 
     };
 
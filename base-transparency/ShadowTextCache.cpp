@@ -0,0 +1,89 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "ShadowTextCache.h"
+#include "Debug.h"
+#include "Effects.h"
+
+#include <QFontMetrics>
+
+namespace Transparency
+{
+
+    //__________________________________________________________________________________
+    void ShadowTextCache::draw( QPainter& painter, const QRect& rect, int flags, const QString& text, const QFont& font, const QColor& color, int radius, qreal devicePixelRatio )
+    {
+
+        if( text.isEmpty() || radius < 1 || !color.isValid() || rect.isEmpty() ) return;
+
+        Key key;
+        key.text = text;
+        key.font = font;
+        key.size = rect.size();
+        key.flags = flags;
+        key.radius = radius;
+        key.color = color.rgba();
+        key.devicePixelRatio = devicePixelRatio;
+
+        auto shadow = cache_.find( key );
+        if( !shadow )
+        {
+            const auto rendered( _render( key ) );
+            shadow = &cache_.insert( key, rendered, rendered.image.sizeInBytes() );
+        }
+
+        if( !shadow->image.isNull() )
+        { painter.drawImage( rect.topLeft() + shadow->position, shadow->image ); }
+
+    }
+
+    //__________________________________________________________________________________
+    ShadowTextCache::Shadow ShadowTextCache::_render( const Key& key ) const
+    {
+
+        Debug::Throw( QStringLiteral("ShadowTextCache::_render.\n") );
+
+        // text bounding rect, extended by the blur tail
+        const QRect rect( QPoint( 0, 0 ), key.size );
+        const int margin = 2*key.radius;
+        const auto textRect( QFontMetrics( key.font ).boundingRect( rect, key.flags, key.text ).adjusted( -margin, -margin, margin, margin ) );
+
+        Shadow shadow;
+        shadow.position = textRect.topLeft();
+        if( textRect.isEmpty() ) return shadow;
+
+        shadow.image = QImage( textRect.size()*key.devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
+        shadow.image.setDevicePixelRatio( key.devicePixelRatio );
+        shadow.image.fill( Qt::transparent );
+
+        {
+            // only the text alpha is used, the color is set by the blur
+            QPainter painter( &shadow.image );
+            painter.translate( -textRect.topLeft() );
+            painter.setPen( Qt::black );
+            painter.setFont( key.font );
+            painter.drawText( rect, key.flags, key.text );
+        }
+
+        Effects::shadowBlur( shadow.image, qRound( key.radius*key.devicePixelRatio ), QColor::fromRgba( key.color ) );
+        return shadow;
+
+    }
+
+}
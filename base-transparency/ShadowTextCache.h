@@ -0,0 +1,146 @@
+#ifndef ShadowTextCache_h
+#define ShadowTextCache_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "Counter.h"
+#include "LruCache.h"
+#include "base_transparency_export.h"
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QPainter>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+
+namespace Transparency
+{
+
+    //* blurred text shadows, reused across paint events
+    /**
+    shadows are rendered over the text bounding rect, extended by the blur radius, rather than the full widget.
+    Entries are keyed by all parameters affecting the result, so that stale entries are never used.
+    Owners should still call clear when the shadow properties change, to release memory early
+    */
+    class BASE_TRANSPARENCY_EXPORT ShadowTextCache: private Base::Counter<ShadowTextCache>
+    {
+
+        public:
+
+        //* constructor
+        explicit ShadowTextCache( qint64 maxCost = 2*1024*1024 ):
+            Counter( QStringLiteral("Transparency::ShadowTextCache") ),
+            cache_( maxCost )
+        {}
+
+        //* key
+        class Key
+        {
+            public:
+
+            //* equal to operator
+            bool operator == ( const Key& other ) const
+            {
+                return
+                    text == other.text &&
+                    size == other.size &&
+                    flags == other.flags &&
+                    radius == other.radius &&
+                    color == other.color &&
+                    devicePixelRatio == other.devicePixelRatio &&
+                    font == other.font;
+            }
+
+            //* text
+            QString text;
+
+            //* font
+            QFont font;
+
+            //* text rect size
+            QSize size;
+
+            //* alignment and text flags
+            int flags = 0;
+
+            //* blur radius
+            int radius = 0;
+
+            //* shadow color
+            QRgb color = 0;
+
+            //* device pixel ratio
+            qreal devicePixelRatio = 1;
+
+        };
+
+        //*@name accessors
+        //@{
+
+        //* statistics
+        const Base::CacheStatistics& statistics() const
+        { return cache_.statistics(); }
+
+        //@}
+
+        //*@name modifiers
+        //@{
+
+        //* draw text shadow for given rect, flags and text
+        void draw( QPainter&, const QRect&, int flags, const QString&, const QFont&, const QColor&, int radius, qreal devicePixelRatio );
+
+        //* clear
+        void clear()
+        { cache_.clear(); }
+
+        //@}
+
+        private:
+
+        //* shadow
+        class Shadow
+        {
+            public:
+
+            //* blurred image
+            QImage image;
+
+            //* image position, relative to the text rect
+            QPoint position;
+
+        };
+
+        //* render shadow
+        Shadow _render( const Key& ) const;
+
+        //* cache
+        Base::LruCache<Key, Shadow> cache_;
+
+    };
+
+    //* hash
+    inline uint qHash( const ShadowTextCache::Key& key )
+    { return qHash( key.text )^qHash( key.font.key() )^(uint( key.size.width() ) << 16)^uint( key.size.height() )^key.color^(uint( key.radius ) << 24); }
+
+}
+
+#endif
@@ -76,6 +76,17 @@ namespace Transparency
         update();
     }
 
+    //____________________________________________________________________
+    void TransparentWidget::setBackgroundRegionChanged( const QRegion& region )
+    {
+        Debug::Throw( QStringLiteral("TransparentWidget::setBackgroundRegionChanged.\n")  );
+        const auto dirty( region.intersected( rect() ) );
+        if( dirty.isEmpty() ) return;
+
+        backgroundDirtyRegion_ += dirty;
+        update( dirty );
+    }
+
     //____________________________________________________________________
     void TransparentWidget::_setForegroundColor( const QColor& color )
     {
@@ -90,6 +101,7 @@ namespace Transparency
         if( !color.isValid() ) return;
         shadowColor_ = color;
         shadowColor_.setAlpha( foregroundIntensity_ );
+        shadowCache_.clear();
     }
 
 
@@ -99,6 +111,7 @@ namespace Transparency
         foregroundIntensity_ = value;
         if( foregroundColor_.isValid() )  foregroundColor_.setAlpha( foregroundIntensity_ );
         if( shadowColor_.isValid() )  shadowColor_.setAlpha( foregroundIntensity_ );
+        shadowCache_.clear();
     }
 
     //____________________________________________________________________
@@ -132,7 +145,6 @@ namespace Transparency
     void TransparentWidget::showEvent( QShowEvent* event )
     {
         setBackgroundChanged( true );
-        update();
         QWidget::showEvent( event );
         _updateInputShape();
     }
@@ -161,18 +173,36 @@ namespace Transparency
         }
 
         if( backgroundChanged_ ) _updateBackgroundPixmap();
+        else if( !backgroundDirtyRegion_.isEmpty() ) _updateBackgroundRegion( backgroundDirtyRegion_ );
+
+        // only blit the exposed part of the background
         if( !backgroundPixmap_.isNull() )
-        { painter.drawPixmap( TransparentWidget::rect(), backgroundPixmap_, TransparentWidget::rect() ); }
+        {
+            const qreal ratio( backgroundPixmap_.devicePixelRatio() );
+            const QRectF source( QPointF( rect.topLeft() )*ratio, QSizeF( rect.size() )*ratio );
+            painter.drawPixmap( QRectF( rect ), backgroundPixmap_, source );
+        }
 
         painter.end();
 
     }
 
+    //________________________________________________________________________
+    void TransparentWidget::_drawText( QPainter& painter, const QRect& rect, int flags, const QString& text )
+    {
+        if( shadowOffset() > 0 && shadowColor().isValid() )
+        { shadowCache_.draw( painter, rect, flags, text, painter.font(), shadowColor(), shadowOffset(), devicePixelRatio_ ); }
+
+        painter.setPen( foregroundColor() );
+        painter.drawText( rect, flags, text );
+    }
+
     //____________________________________________________________________
     void TransparentWidget::_toggleInverseColors( bool value )
     {
         Debug::Throw( QStringLiteral("TransparentWidget::_toggleInverseColors.\n") );
         XmlOptions::get().set<bool>( QStringLiteral("TRANSPARENCY_INVERSE_COLORS"), value );
+        shadowCache_.clear();
         update();
     }
 
@@ -228,16 +258,32 @@ namespace Transparency
 
         Debug::Throw( QStringLiteral("TransparentWidget::_updateBackgroundPixmap.\n") );
 
-        backgroundPixmap_ = QPixmap( size() );
-        if( CompositeEngine::get().isAvailable() ) backgroundPixmap_.fill( Qt::transparent );
-        else if( !( tintColor_.isValid() && tintColor_.alpha() == 255 ) ) backgroundPixmap_.fill( palette().color( backgroundRole() ) );
-
-        // tint
-        if( tintColor_.isValid() ) backgroundPixmap_.fill( tintColor_ );
+        // reuse existing pixmap when size is unchanged
+        if( backgroundPixmap_.size() != size() ) backgroundPixmap_ = QPixmap( size() );
+        _updateBackgroundRegion( rect() );
 
         setBackgroundChanged( false );
 
-        return;
+    }
+
+    //____________________________________________________________________
+    void TransparentWidget::_updateBackgroundRegion( const QRegion& region )
+    {
+
+        Debug::Throw( QStringLiteral("TransparentWidget::_updateBackgroundRegion.\n") );
+        backgroundDirtyRegion_ -= region;
+        if( backgroundPixmap_.isNull() ) return;
+
+        // tint replaces the background color
+        QColor color;
+        if( tintColor_.isValid() ) color = tintColor_;
+        else if( CompositeEngine::get().isAvailable() ) color = Qt::transparent;
+        else color = palette().color( backgroundRole() );
+
+        QPainter painter( &backgroundPixmap_ );
+        painter.setCompositionMode( QPainter::CompositionMode_Source );
+        for( const auto& rect:region )
+        { painter.fillRect( rect, color ); }
 
     }
 
@@ -248,7 +294,12 @@ namespace Transparency
         Debug::Throw( QStringLiteral("TransparentWidget::_installAction.\n") );
 
         addAction( reloadBlurRegionAction_ = new QAction( IconEngine::get( IconNames::Reload ), tr( "Reload Blur Region" ), this ) );
-        connect( reloadBlurRegionAction_, &QAction::triggered, this, QOverload<>::of( &TransparentWidget::_updateBlurRegion) );
+        connect( reloadBlurRegionAction_, &QAction::triggered, this, [this]()
+        {
+            // force sending the property again
+            blurRegionData_.clear();
+            _updateBlurRegion();
+        } );
 
         addAction( inverseColorsAction_ = new QAction( tr( "Inverse Colors" ), this ) );
         inverseColorsAction_->setCheckable( true );
@@ -319,7 +370,7 @@ namespace Transparency
 
         // create data
         blurRegion_ = region;
-        using Vector = QVector<int32_t>;
+        using Vector = QVector<qint32>;
         Vector data;
         for( const auto& r:region )
         {
@@ -330,10 +381,16 @@ namespace Transparency
                 << devicePixelRatio_*r.height();
         }
 
+        // skip when unchanged. Native window is checked too, since it loses its properties when re-created
+        const WId windowId( winId() );
+        if( windowId == blurRegionWinId_ && data == blurRegionData_ ) return;
+        blurRegionData_ = data;
+        blurRegionWinId_ = windowId;
+
         // get connection and atom
         auto connection = XcbUtil::get().connection<xcb_connection_t>();
         xcb_atom_t atom( *XcbUtil::get().atom<xcb_atom_t>( XcbDefines::AtomId::_KDE_NET_WM_BLUR_BEHIND_REGION ) );
-        xcb_change_property( connection, XCB_PROP_MODE_REPLACE, winId(), atom, XCB_ATOM_CARDINAL, 32, data.size(), data.constData() );
+        xcb_change_property( connection, XCB_PROP_MODE_REPLACE, windowId, atom, XCB_ATOM_CARDINAL, 32, data.size(), data.constData() );
         xcb_flush( connection );
 
         #endif
@@ -22,12 +22,14 @@
 
 #include "Counter.h"
 #include "Margins.h"
+#include "ShadowTextCache.h"
 #include "base_transparency_export.h"
 
 #include <QAction>
 #include <QPaintEvent>
 #include <QResizeEvent>
 #include <QShowEvent>
+#include <QVector>
 #include <QWidget>
 
 namespace Transparency
@@ -84,18 +86,28 @@ namespace Transparency
 
         //* background changed
         void setBackgroundChanged( bool value )
-        { backgroundChanged_ = value; }
+        {
+            backgroundChanged_ = value;
+            if( !value ) backgroundDirtyRegion_ = QRegion();
+        }
 
         //* force reloading of the background
         virtual void setBackgroundChanged();
 
+        //* force reloading of the background in a given region, and repaint only that region
+        virtual void setBackgroundRegionChanged( const QRegion& );
+
         //@}
 
         protected:
 
         //* device pixel ratio
         virtual void _setDevicePixelRatio( qreal ratio )
-        { devicePixelRatio_ = ratio; }
+        {
+            if( devicePixelRatio_ == ratio ) return;
+            devicePixelRatio_ = ratio;
+            shadowCache_.clear();
+        }
         
         //* foreground
         virtual void _setForegroundColor( const QColor& );
@@ -112,7 +124,11 @@ namespace Transparency
 
         //* shadow offset
         virtual void _setShadowOffset( int value )
-        { shadowOffset_ = value; }
+        {
+            if( shadowOffset_ == value ) return;
+            shadowOffset_ = value;
+            shadowCache_.clear();
+        }
 
         //* foreground intensity
         virtual void _setForegroundIntensity( int value );
@@ -183,6 +199,9 @@ namespace Transparency
         //* paint background on devide
         virtual void _paintBackground( QPaintDevice&, QRect );
 
+        //* draw text with foreground color and cached shadow
+        virtual void _drawText( QPainter&, const QRect&, int flags, const QString& );
+
         //* paint main widget on devide
         /*! this must be re-implemented by derived classes */
         virtual void _paint( QPaintDevice&, QRect )
@@ -195,8 +214,12 @@ namespace Transparency
         virtual void _updateBlurRegion( const QRegion& );
 
         //* update background pixmap
+        /** the pixmap is only re-allocated when the widget size has changed */
         virtual void _updateBackgroundPixmap();
 
+        //* update background pixmap in a given region
+        virtual void _updateBackgroundRegion( const QRegion& );
+
         //* update blur region
         virtual void _updateBlurRegion()
         {
@@ -256,9 +279,21 @@ namespace Transparency
         //* margins
         Base::Margins outerPadding_;
 
+        //* text shadows
+        ShadowTextCache shadowCache_;
+
         //* store last blur region
         QRegion blurRegion_;
 
+        //* blur region property, as last sent to the X server
+        QVector<qint32> blurRegionData_;
+
+        //* window to which blur region data was last sent
+        WId blurRegionWinId_ = 0;
+
+        //* background region that needs to be reloaded
+        QRegion backgroundDirtyRegion_;
+
         #if defined(Q_OS_WIN)
         //* widget pixmap
         /*! it is used as widget storage when using full translucency */
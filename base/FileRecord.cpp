@@ -19,6 +19,8 @@
 
 #include "FileRecord.h"
 
+#include <QPair>
+
 //_______________________________________________
 const QString FileRecord::MimeType( QStringLiteral("internal/file-record-list") );
 
@@ -80,3 +82,94 @@ FileRecord& FileRecord::addProperty( PropertyId::Id id, const QString& value )
     properties_[ id ] = value;
     return *this;
 }
+
+namespace
+{
+
+    //* maximum number of interned strings, per value type
+    static const int maxInternedStrings = 1<<16;
+
+    //* interned size strings
+    using SizeStringMap = QHash<qint64, QString>;
+    SizeStringMap& _sizeStrings()
+    {
+        static SizeStringMap strings;
+        return strings;
+    }
+
+    //* interned time strings, keyed by format and time
+    using TimeStringMap = QHash<QPair<int, qint64>, QString>;
+    TimeStringMap& _timeStrings()
+    {
+        static TimeStringMap strings;
+        return strings;
+    }
+
+}
+
+//_______________________________________________
+quint32& FileRecord::_displayGeneration()
+{
+    static quint32 generation(1);
+    return generation;
+}
+
+//_______________________________________________
+void FileRecord::invalidateDisplayStrings()
+{
+    ++_displayGeneration();
+    _sizeStrings().clear();
+    _timeStrings().clear();
+}
+
+//_______________________________________________
+void FileRecord::_checkDisplayStrings() const
+{
+    if( displayGeneration_ == _displayGeneration() ) return;
+    sizeString_.clear();
+    timeString_.clear();
+    displayGeneration_ = _displayGeneration();
+}
+
+//_______________________________________________
+const QString& FileRecord::sizeString() const
+{
+    _checkDisplayStrings();
+    if( sizeString_.isNull() )
+    {
+        auto& strings( _sizeStrings() );
+        auto iter( strings.constFind( size_ ) );
+        if( iter == strings.cend() )
+        {
+            if( strings.size() >= maxInternedStrings ) strings.clear();
+            iter = strings.insert( size_, QString::number( size_ ) );
+        }
+
+        sizeString_ = iter.value();
+    }
+
+    return sizeString_;
+}
+
+//_______________________________________________
+const QString& FileRecord::timeString( TimeStamp::Format format ) const
+{
+    _checkDisplayStrings();
+    if( timeString_.isNull() || timeFormat_ != format )
+    {
+        // identical formatted values are shared, using the time and format as key
+        auto& strings( _timeStrings() );
+        const auto key( qMakePair( static_cast<int>( format ), static_cast<qint64>( time_.unixTime() ) ) );
+        auto iter( strings.constFind( key ) );
+        if( iter == strings.cend() )
+        {
+            if( strings.size() >= maxInternedStrings ) strings.clear();
+            iter = strings.insert( key, time_.toString( format ) );
+        }
+
+        timeString_ = iter.value();
+        timeFormat_ = format;
+    }
+
+    return timeString_;
+}
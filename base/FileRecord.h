@@ -77,6 +77,30 @@ class BASE_EXPORT FileRecord: private Base::Counter<FileRecord>
     const TimeStamp& time() const
     { return time_; }
 
+    //* size, in bytes. Negative if unknown
+    qint64 size() const
+    { return size_; }
+
+    //*@name cached display strings
+    /**
+    strings are formatted on first access and kept until either the
+    corresponding value changes or invalidateDisplayStrings is called.
+    Identical values share the same string.
+    Must only be used from the GUI thread
+    */
+    //@{
+
+    //* formatted size
+    const QString& sizeString() const;
+
+    //* formatted time
+    const QString& timeString( TimeStamp::Format = TimeStamp::Format::Short ) const;
+
+    //* invalidate display strings of all records, for instance on locale or format change
+    static void invalidateDisplayStrings();
+
+    //@}
+
     //* flags
     int flags() const
     { return flags_; }
@@ -166,6 +190,15 @@ class BASE_EXPORT FileRecord: private Base::Counter<FileRecord>
     FileRecord& setTime( const TimeStamp& time )
     {
         time_ = time;
+        timeString_.clear();
+        return *this;
+    }
+
+    //* size
+    FileRecord& setSize( qint64 value )
+    {
+        size_ = value;
+        sizeString_.clear();
         return *this;
     }
 
@@ -222,6 +255,12 @@ class BASE_EXPORT FileRecord: private Base::Counter<FileRecord>
 
     private:
 
+    //* make sure cached display strings match current generation
+    void _checkDisplayStrings() const;
+
+    //* display strings generation
+    static quint32& _displayGeneration();
+
     //* file
     File file_;
 
@@ -231,6 +270,26 @@ class BASE_EXPORT FileRecord: private Base::Counter<FileRecord>
     //* time
     TimeStamp time_;
 
+    //* size
+    qint64 size_ = -1;
+
+    //*@name cached display strings
+    //@{
+
+    //* size string
+    mutable QString sizeString_;
+
+    //* time string
+    mutable QString timeString_;
+
+    //* time string format
+    mutable TimeStamp::Format timeFormat_ = TimeStamp::Format::Short;
+
+    //* generation
+    mutable quint32 displayGeneration_ = 0;
+
+    //@}
+
     //* flags
     int flags_ = 0;
 
@@ -117,6 +117,7 @@ void Options::clearSpecialOptions( const QString& name )
 {
     Q_ASSERT( isSpecialOption( name ) );
     specialOptions_[name].clear();
+    ++revision_;
 }
 
 //________________________________________________
@@ -128,6 +129,7 @@ void Options::set( const QString& name, const Option& constOption, bool isDefaul
 
     // options_[name] = option;
     Base::insert( options_, name, option );
+    ++revision_;
 }
 
 //________________________________________________
@@ -150,6 +152,8 @@ bool Options::add( const QString& name, const Option& constOption, bool isDefaul
     auto option( constOption );
     if( isDefault || _autoDefault() ) option.setDefault();
 
+    ++revision_;
+
     // if option is first, set as current
     if( iter.value().empty() ) option.setCurrent( true );
     else if( option.isCurrent() )
@@ -184,6 +188,8 @@ bool Options::add( const QString& name, const Option& constOption, bool isDefaul
 void Options::restoreDefaults()
 {
 
+    ++revision_;
+
     // restore standard options
     for( auto&& iter = options_.begin(); iter != options_.end(); ++iter )
     {
@@ -96,6 +96,10 @@ class BASE_EXPORT Options: private Base::Counter<Options>
     QByteArray raw( const QString& name ) const
     { return _find( name ).value().raw(); }
 
+    //* revision, incremented each time options are modified
+    quint64 revision() const
+    { return revision_; }
+
     //@}
 
     //*@name modifiers
@@ -133,6 +137,7 @@ class BASE_EXPORT Options: private Base::Counter<Options>
         Option &option( options_[name] );
         option.set<T>( value );
         if( isDefault || _autoDefault() ) option.setDefault();
+        ++revision_;
 
     }
 
@@ -143,6 +148,7 @@ class BASE_EXPORT Options: private Base::Counter<Options>
         Option &option( options_[name] );
         option.setRaw( value );
         if( isDefault || _autoDefault() ) option.setDefault();
+        ++revision_;
     }
 
     //* option raw value modifier
@@ -152,6 +158,7 @@ class BASE_EXPORT Options: private Base::Counter<Options>
         Option &option( options_[name] );
         option.setRaw( value.toUtf8() );
         if( isDefault || _autoDefault() ) option.setDefault();
+        ++revision_;
     }
 
     /** \brief
@@ -164,7 +171,10 @@ class BASE_EXPORT Options: private Base::Counter<Options>
     void keep( const QString& name )
     {
         if( specialOptions_.find( name ) == specialOptions_.end() )
-        { specialOptions_.insert( name, List() ); }
+        {
+            specialOptions_.insert( name, List() );
+            ++revision_;
+        }
     }
 
     //* auto-default
@@ -216,6 +226,9 @@ class BASE_EXPORT Options: private Base::Counter<Options>
     //* if true all options inserted are also set as default
     bool autoDefault_ = false;
 
+    //* revision
+    quint64 revision_ = 0;
+
     //* streamer
     friend BASE_EXPORT QTextStream &operator << ( QTextStream &,const Options &);
 
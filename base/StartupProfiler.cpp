@@ -0,0 +1,307 @@
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "StartupProfiler.h"
+#include "NonCopyable.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include <atomic>
+
+namespace
+{
+
+    //* maximum number of recorded events
+    static const int maxEvents = 100000;
+
+    //* track used for startup stages
+    static const int stageTrack = 0;
+
+    //* make sure the clock starts when the library is loaded
+    static const qint64 clockStart = StartupProfiler::elapsed();
+
+}
+
+//__________________________________________________________
+class StartupProfiler::Private final: private Base::NonCopyable<StartupProfiler::Private>
+{
+
+    public:
+
+    //* state
+    enum class State
+    {
+        Enabled,
+        Disabled
+    };
+
+    //* event
+    class Event
+    {
+        public:
+
+        //* name
+        QString name;
+
+        //* track
+        int track = 0;
+
+        //* begin time (us)
+        qint64 begin = 0;
+
+        //* duration (us), or -1 for instant markers
+        qint64 duration = -1;
+
+    };
+
+    //* constructor
+    Private()
+    {
+        clock_.start();
+        tracks_.insert( nullptr, stageTrack );
+        trackNames_.append( QStringLiteral("startup stages") );
+
+        // enable from environment
+        const QByteArray fileName( qgetenv( "BASE_TRACE_STARTUP" ) );
+        if( !fileName.isEmpty() )
+        {
+            fileName_ = QString::fromLocal8Bit( fileName );
+            state_ = State::Enabled;
+        }
+
+    }
+
+    //* true if recording
+    bool isEnabled() const
+    { return state_ == State::Enabled; }
+
+    //* add event
+    void add( const QString&, int, qint64, qint64 );
+
+    //* track for current thread
+    int currentTrack();
+
+    //* state
+    std::atomic<State> state_{ State::Disabled };
+
+    //* monotonic clock
+    QElapsedTimer clock_;
+
+    //* mutex
+    QMutex mutex_;
+
+    //* output file
+    QString fileName_;
+
+    //* tracks, indexed by thread
+    QHash<const QThread*, int> tracks_;
+
+    //* track names
+    QVector<QString> trackNames_;
+
+    //* events
+    QVector<Event> events_;
+
+};
+
+//__________________________________________________________
+void StartupProfiler::Private::add( const QString& name, int track, qint64 begin, qint64 duration )
+{
+    if( events_.size() >= maxEvents ) return;
+
+    Event event;
+    event.name = name;
+    event.track = track;
+    event.begin = begin;
+    event.duration = duration;
+    events_.append( event );
+}
+
+//__________________________________________________________
+int StartupProfiler::Private::currentTrack()
+{
+    const auto thread( QThread::currentThread() );
+    const auto iter( tracks_.constFind( thread ) );
+    if( iter != tracks_.constEnd() ) return iter.value();
+
+    // name track from thread
+    QString name( thread->objectName() );
+    if( QCoreApplication::instance() && thread == QCoreApplication::instance()->thread() ) name = QStringLiteral("main");
+    else if( name.isEmpty() ) name = QStringLiteral("%1 %2").arg( QString::fromLatin1( thread->metaObject()->className() ) ).arg( trackNames_.size() );
+
+    const int track( trackNames_.size() );
+    tracks_.insert( thread, track );
+    trackNames_.append( name );
+    return track;
+}
+
+//_________________________________________________________________
+bool StartupProfiler::isEnabled()
+{ return _get().isEnabled(); }
+
+//_________________________________________________________________
+qint64 StartupProfiler::elapsed()
+{ return _get().clock_.nsecsElapsed()/1000; }
+
+//_________________________________________________________________
+QString StartupProfiler::fileName()
+{
+    QMutexLocker lock( &_get().mutex_ );
+    return _get().fileName_;
+}
+
+//_________________________________________________________________
+void StartupProfiler::setEnabled( bool value )
+{
+    auto& d( _get() );
+    QMutexLocker lock( &d.mutex_ );
+    d.state_ = value ? Private::State::Enabled:Private::State::Disabled;
+    if( !value ) d.events_.clear();
+}
+
+//_________________________________________________________________
+void StartupProfiler::setFileName( const QString& value )
+{
+    QMutexLocker lock( &_get().mutex_ );
+    _get().fileName_ = value;
+}
+
+//_________________________________________________________________
+void StartupProfiler::addPhase( const QString& name, qint64 begin, qint64 end )
+{
+    auto& d( _get() );
+    if( !d.isEnabled() ) return;
+
+    QMutexLocker lock( &d.mutex_ );
+    d.add( name, d.currentTrack(), begin, qMax<qint64>( 0, end - begin ) );
+}
+
+//_________________________________________________________________
+void StartupProfiler::addStage( const QString& name, qint64 begin, qint64 end )
+{
+    auto& d( _get() );
+    if( !d.isEnabled() ) return;
+
+    QMutexLocker lock( &d.mutex_ );
+    d.add( name, stageTrack, begin, qMax<qint64>( 0, end - begin ) );
+}
+
+//_________________________________________________________________
+void StartupProfiler::addMark( const QString& name )
+{
+    auto& d( _get() );
+    if( !d.isEnabled() ) return;
+
+    const qint64 time( elapsed() );
+    QMutexLocker lock( &d.mutex_ );
+    d.add( name, d.currentTrack(), time, -1 );
+}
+
+//_________________________________________________________________
+bool StartupProfiler::write()
+{
+
+    auto& d( _get() );
+
+    QJsonArray events;
+    QString fileName;
+    {
+
+        QMutexLocker lock( &d.mutex_ );
+        if( d.state_ != Private::State::Enabled || d.fileName_.isEmpty() ) return false;
+        fileName = d.fileName_;
+
+        const qint64 pid( QCoreApplication::applicationPid() );
+
+        // process and track names
+        events.append( QJsonObject( {
+            { QStringLiteral("name"), QStringLiteral("process_name") },
+            { QStringLiteral("ph"), QStringLiteral("M") },
+            { QStringLiteral("pid"), pid },
+            { QStringLiteral("args"), QJsonObject( { { QStringLiteral("name"), QCoreApplication::applicationName() } } ) } } ) );
+
+        for( int track = 0; track < d.trackNames_.size(); ++track )
+        {
+            events.append( QJsonObject( {
+                { QStringLiteral("name"), QStringLiteral("thread_name") },
+                { QStringLiteral("ph"), QStringLiteral("M") },
+                { QStringLiteral("pid"), pid },
+                { QStringLiteral("tid"), track },
+                { QStringLiteral("args"), QJsonObject( { { QStringLiteral("name"), d.trackNames_[track] } } ) } } ) );
+        }
+
+        // events
+        for( const auto& event:d.events_ )
+        {
+            QJsonObject object( {
+                { QStringLiteral("name"), event.name },
+                { QStringLiteral("cat"), QStringLiteral("startup") },
+                { QStringLiteral("pid"), pid },
+                { QStringLiteral("tid"), event.track },
+                { QStringLiteral("ts"), event.begin } } );
+
+            if( event.duration < 0 )
+            {
+                object.insert( QStringLiteral("ph"), QStringLiteral("i") );
+                object.insert( QStringLiteral("s"), QStringLiteral("t") );
+            } else {
+                object.insert( QStringLiteral("ph"), QStringLiteral("X") );
+                object.insert( QStringLiteral("dur"), event.duration );
+            }
+
+            events.append( object );
+        }
+
+    }
+
+    QFile out( fileName );
+    if( !out.open( QIODevice::WriteOnly ) ) return false;
+
+    const QJsonObject document( {
+        { QStringLiteral("traceEvents"), events },
+        { QStringLiteral("displayTimeUnit"), QStringLiteral("ms") } } );
+    return out.write( QJsonDocument( document ).toJson( QJsonDocument::Compact ) ) >= 0;
+
+}
+
+//_________________________________________________________________
+bool StartupProfiler::finish()
+{
+    if( !isEnabled() ) return false;
+    const bool success( write() );
+    setEnabled( false );
+    return success;
+}
+
+//_________________________________________________________________
+StartupProfiler::Private& StartupProfiler::_get()
+{
+    static Private singleton;
+    return singleton;
+}
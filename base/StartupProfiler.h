@@ -0,0 +1,117 @@
+#ifndef StartupProfiler_h
+#define StartupProfiler_h
+
+/******************************************************************************
+*
+* Copyright (C) 2002 Hugo PEREIRA <mailto: hugo.pereira@free.fr>
+*
+* This is free software; you can redistribute it and/or modify it under the
+* terms of the GNU General Public License as published by the Free Software
+* Foundation; either version 2 of the License, or (at your option) any later
+* version.
+*
+* This software is distributed in the hope that it will be useful, but WITHOUT
+* Any WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along with
+* this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*******************************************************************************/
+
+#include "base_export.h"
+
+#include <QString>
+
+//* startup phase profiler
+/**
+records scoped phase markers with monotonic timestamps, on one track per thread,
+and exports them in Chrome trace event format, to be loaded in chrome://tracing or perfetto.
+The clock starts when the library is loaded. The profiler is disabled by default. It is enabled
+when the library is loaded if the BASE_TRACE_STARTUP environment variable is set to the output file,
+so that phases preceding command line parsing are recorded, or explicitly, using setEnabled.
+Recording stops, and all recorded events are discarded, once startup is finished
+*/
+class BASE_EXPORT StartupProfiler final
+{
+    public:
+
+    //*@name static accessors
+    //@{
+
+    //* true if events are recorded
+    static bool isEnabled();
+
+    //* time elapsed since clock start, in microseconds
+    static qint64 elapsed();
+
+    //* output file name
+    static QString fileName();
+
+    //@}
+
+    //*@name static modifiers
+    //@{
+
+    //* enable or disable
+    static void setEnabled( bool );
+
+    //* set output file name
+    static void setFileName( const QString& );
+
+    //* add phase on current thread, with begin and end time in microseconds
+    static void addPhase( const QString&, qint64, qint64 );
+
+    //* add startup stage, with begin and end time in microseconds
+    /** stages are sequential, and stored on a dedicated track */
+    static void addStage( const QString&, qint64, qint64 );
+
+    //* add instant marker on current thread
+    static void addMark( const QString& );
+
+    //* write events to output file, in chrome trace event format. Returns true on success
+    static bool write();
+
+    //* write events to output file and stop recording. Returns true on success
+    static bool finish();
+
+    //@}
+
+    //* scoped phase marker
+    /** records a phase on the current thread, from construction to destruction */
+    class BASE_EXPORT Scope final
+    {
+
+        public:
+
+        //* constructor
+        explicit Scope( const char* name ):
+            name_( name ),
+            begin_( isEnabled() ? elapsed():-1 )
+        {}
+
+        //* destructor
+        ~Scope()
+        { if( begin_ >= 0 && isEnabled() ) addPhase( QString::fromLatin1( name_ ), begin_, elapsed() ); }
+
+        private:
+
+        //* name
+        const char* name_ = nullptr;
+
+        //* begin time, or -1 if disabled
+        qint64 begin_ = -1;
+
+    };
+
+    private:
+
+    class BASE_EXPORT Private;
+
+    //* return singleton
+    static Private& _get();
+
+};
+
+#endif